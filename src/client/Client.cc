@@ -575,6 +575,14 @@ void Client::_finish_init()
     plb.add_time_avg(l_c_wrlat, "wrlat", "Latency of a file data write operation");
     plb.add_time_avg(l_c_read, "rdlat", "Latency of a file data read operation");
     plb.add_time_avg(l_c_fsync, "fsync", "Latency of a file sync operation");
+    plb.add_u64_counter(l_c_read_hit, "read_hit",
+                        "Reads served entirely from the object cache");
+    plb.add_u64_counter(l_c_readahead, "readahead_bytes",
+                        "Bytes requested by file readahead",
+                        NULL, 0, unit_t(UNIT_BYTES));
+    plb.add_u64_counter(l_c_readahead_waste, "readahead_waste",
+                        "Readahead bytes abandoned when the access pattern changed",
+                        NULL, 0, unit_t(UNIT_BYTES));
     logger.reset(plb.create_perf_counters());
     cct->get_perfcounters_collection()->add(logger.get());
   }
@@ -8848,7 +8856,10 @@ int Client::readdir_r_cb(dir_result_t *d, add_dirent_cb_t cb, void *p,
       int r;
       if (check_caps) {
 	int mask = caps;
-	if(entry.inode->is_dir()){
+	// rstat is not protected by any cap, only fetch it when it is what
+	// fill_statx() reports as the directory size
+	if (entry.inode->is_dir() && (caps & CEPH_STAT_CAP_SIZE) &&
+	    cct->_conf->client_dirsize_rbytes) {
           mask |= CEPH_STAT_RSTAT;
 	}
 	r = _getattr(entry.inode, mask, dirp->perms);
@@ -9370,7 +9381,6 @@ Fh *Client::_create_fh(Inode *in, int flags, int cmode, const UserPerm& perms)
 
   const auto& conf = cct->_conf;
   f->readahead.set_trigger_requests(1);
-  f->readahead.set_min_readahead_size(conf->client_readahead_min);
   uint64_t max_readahead = Readahead::NO_LIMIT;
   if (conf->client_readahead_max_bytes) {
     max_readahead = std::min(max_readahead, (uint64_t)conf->client_readahead_max_bytes);
@@ -9378,6 +9388,15 @@ Fh *Client::_create_fh(Inode *in, int flags, int cmode, const UserPerm& perms)
   if (conf->client_readahead_max_periods) {
     max_readahead = std::min(max_readahead, in->layout.get_period()*(uint64_t)conf->client_readahead_max_periods);
   }
+  // for striped layouts, start with a full stripe so that the first
+  // readahead already spreads over every object of the stripe in parallel.
+  // a zero client_readahead_min disables readahead, keep it that way.
+  uint64_t min_readahead = conf->client_readahead_min;
+  if (min_readahead > 0 && in->layout.stripe_count > 1) {
+    uint64_t stripe = (uint64_t)in->layout.stripe_unit * in->layout.stripe_count;
+    min_readahead = std::max(min_readahead, std::min(stripe, max_readahead));
+  }
+  f->readahead.set_min_readahead_size(min_readahead);
   f->readahead.set_max_readahead_size(max_readahead);
   vector<uint64_t> alignments;
   alignments.push_back(in->layout.get_period());
@@ -9995,10 +10014,17 @@ int Client::_read_async(Fh *f, uint64_t off, uint64_t len, bufferlist *bl)
     r = onfinish.wait();
     client_lock.lock();
     put_cap_ref(in, CEPH_CAP_FILE_CACHE);
+  } else if (r > 0) {
+    // file_read() returns the length when it is served from the cache,
+    // and an error otherwise
+    logger->inc(l_c_read_hit);
   }
 
   if(f->readahead.get_min_readahead_size() > 0) {
     pair<uint64_t, uint64_t> readahead_extent = f->readahead.update(off, len, in->size);
+    uint64_t wasted = f->readahead.take_wasted_bytes();
+    if (wasted)
+      logger->inc(l_c_readahead_waste, wasted);
     if (readahead_extent.second > 0) {
       ldout(cct, 20) << "readahead " << readahead_extent.first << "~" << readahead_extent.second
 		     << " (caller wants " << off << "~" << len << ")" << dendl;
@@ -10009,6 +10035,7 @@ int Client::_read_async(Fh *f, uint64_t off, uint64_t len, bufferlist *bl)
       if (r2 == 0) {
 	ldout(cct, 20) << "readahead initiated, c " << onfinish2 << dendl;
 	get_cap_ref(in, CEPH_CAP_FILE_RD | CEPH_CAP_FILE_CACHE);
+	logger->inc(l_c_readahead, readahead_extent.second);
       } else {
 	ldout(cct, 20) << "readahead was no-op, already cached" << dendl;
 	delete onfinish2;
@@ -10103,6 +10130,14 @@ int Client::write(int fd, const char *buf, loff_t size, loff_t offset)
   tout(cct) << size << std::endl;
   tout(cct) << offset << std::endl;
 
+  /* We can't return bytes written larger than INT_MAX, clamp size to that */
+  size = std::min(size, (loff_t)INT_MAX);
+  // copy into fresh buffer (since our write may be resub, async) before
+  // taking client_lock; it only touches caller memory.
+  bufferlist bl;
+  if (size > 0)
+    bl.append(buf, size);
+
   std::scoped_lock lock(client_lock);
   Fh *fh = get_filehandle(fd);
   if (!fh)
@@ -10111,9 +10146,7 @@ int Client::write(int fd, const char *buf, loff_t size, loff_t offset)
   if (fh->flags & O_PATH)
     return -CEPHFS_EBADF;
 #endif
-  /* We can't return bytes written larger than INT_MAX, clamp size to that */
-  size = std::min(size, (loff_t)INT_MAX);
-  int r = _write(fh, offset, size, buf, NULL, false);
+  int r = _write(fh, offset, size, bl);
   ldout(cct, 3) << "write(" << fd << ", \"...\", " << size << ", " << offset << ") = " << r << dendl;
   return r;
 }
@@ -10125,9 +10158,47 @@ int Client::pwritev(int fd, const struct iovec *iov, int iovcnt, int64_t offset)
   return _preadv_pwritev(fd, iov, iovcnt, offset, true);
 }
 
+static loff_t iov_total_len(const struct iovec *iov, unsigned iovcnt,
+                            bool clamp_to_int)
+{
+  loff_t totallen = 0;
+  for (unsigned i = 0; i < iovcnt; i++) {
+    totallen += iov[i].iov_len;
+  }
+
+  /*
+   * Some of the API functions take 64-bit size values, but only return
+   * 32-bit signed integers. Clamp the I/O sizes in those functions so that
+   * we don't do I/Os larger than the values we can return.
+   */
+  if (clamp_to_int) {
+    totallen = std::min(totallen, (loff_t)INT_MAX);
+  }
+  return totallen;
+}
+
+/*
+ * Copy a write payload into a fresh buffer (since our write may be resub,
+ * async).  This only touches caller memory, so callers do it before they
+ * take client_lock.
+ */
+static void copy_write_payload(const struct iovec *iov, unsigned iovcnt,
+                               bool clamp_to_int, bufferlist *bl)
+{
+  uint64_t resid = iov_total_len(iov, iovcnt, clamp_to_int);
+  for (unsigned i = 0; i < iovcnt && resid > 0; i++) {
+    const auto len = std::min<uint64_t>(resid, iov[i].iov_len);
+    if (len > 0) {
+      bl->append((const char *)iov[i].iov_base, len);
+      resid -= len;
+    }
+  }
+}
+
 int64_t Client::_preadv_pwritev_locked(Fh *fh, const struct iovec *iov,
                                        unsigned iovcnt, int64_t offset,
-                                       bool write, bool clamp_to_int)
+                                       bool write, bool clamp_to_int,
+                                       bufferlist *wbl)
 {
     ceph_assert(ceph_mutex_is_locked_by_me(client_lock));
 
@@ -10135,24 +10206,14 @@ int64_t Client::_preadv_pwritev_locked(Fh *fh, const struct iovec *iov,
     if (fh->flags & O_PATH)
         return -CEPHFS_EBADF;
 #endif
-    loff_t totallen = 0;
-    for (unsigned i = 0; i < iovcnt; i++) {
-        totallen += iov[i].iov_len;
-    }
-
-    /*
-     * Some of the API functions take 64-bit size values, but only return
-     * 32-bit signed integers. Clamp the I/O sizes in those functions so that
-     * we don't do I/Os larger than the values we can return.
-     */
-    if (clamp_to_int) {
-      totallen = std::min(totallen, (loff_t)INT_MAX);
-    }
     if (write) {
-        int64_t w = _write(fh, offset, totallen, NULL, iov, iovcnt);
+        ceph_assert(wbl);
+        const uint64_t totallen = wbl->length();
+        int64_t w = _write(fh, offset, totallen, *wbl);
         ldout(cct, 3) << "pwritev(" << fh << ", \"...\", " << totallen << ", " << offset << ") = " << w << dendl;
         return w;
     } else {
+        const loff_t totallen = iov_total_len(iov, iovcnt, clamp_to_int);
         bufferlist bl;
         int64_t r = _read(fh, offset, totallen, &bl);
         ldout(cct, 3) << "preadv(" << fh << ", " <<  offset << ") = " << r << dendl;
@@ -10185,15 +10246,18 @@ int Client::_preadv_pwritev(int fd, const struct iovec *iov, unsigned iovcnt, in
     tout(cct) << fd << std::endl;
     tout(cct) << offset << std::endl;
 
+    bufferlist wbl;
+    if (write)
+      copy_write_payload(iov, iovcnt, true, &wbl);
+
     std::scoped_lock cl(client_lock);
     Fh *fh = get_filehandle(fd);
     if (!fh)
       return -CEPHFS_EBADF;
-    return _preadv_pwritev_locked(fh, iov, iovcnt, offset, write, true);
+    return _preadv_pwritev_locked(fh, iov, iovcnt, offset, write, true, &wbl);
 }
 
-int64_t Client::_write(Fh *f, int64_t offset, uint64_t size, const char *buf,
-	                const struct iovec *iov, int iovcnt)
+int64_t Client::_write(Fh *f, int64_t offset, uint64_t size, bufferlist& bl)
 {
   ceph_assert(ceph_mutex_is_locked_by_me(client_lock));
 
@@ -10255,19 +10319,6 @@ int64_t Client::_write(Fh *f, int64_t offset, uint64_t size, const char *buf,
     ceph_assert(in->inline_version > 0);
   }
 
-  // copy into fresh buffer (since our write may be resub, async)
-  bufferlist bl;
-  if (buf) {
-    if (size > 0)
-      bl.append(buf, size);
-  } else if (iov){
-    for (int i = 0; i < iovcnt; i++) {
-      if (iov[i].iov_len > 0) {
-        bl.append((const char *)iov[i].iov_base, iov[i].iov_len);
-      }
-    }
-  }
-
   utime_t lat;
   uint64_t totalwritten;
   int want, have;
@@ -14336,9 +14387,13 @@ int Client::ll_write(Fh *fh, loff_t off, loff_t len, const char *data)
 
   /* We can't return bytes written larger than INT_MAX, clamp len to that */
   len = std::min(len, (loff_t)INT_MAX);
+  bufferlist bl;
+  if (len > 0)
+    bl.append(data, len);
+
   std::scoped_lock lock(client_lock);
 
-  int r = _write(fh, off, len, data, NULL, 0);
+  int r = _write(fh, off, len, bl);
   ldout(cct, 3) << "ll_write " << fh << " " << off << "~" << len << " = " << r
 		<< dendl;
   return r;
@@ -14350,8 +14405,11 @@ int64_t Client::ll_writev(struct Fh *fh, const struct iovec *iov, int iovcnt, in
   if (!mref_reader.is_state_satisfied())
     return -CEPHFS_ENOTCONN;
 
+  bufferlist bl;
+  copy_write_payload(iov, iovcnt, false, &bl);
+
   std::scoped_lock cl(client_lock);
-  return _preadv_pwritev_locked(fh, iov, iovcnt, off, true, false);
+  return _preadv_pwritev_locked(fh, iov, iovcnt, off, true, false, &bl);
 }
 
 int64_t Client::ll_readv(struct Fh *fh, const struct iovec *iov, int iovcnt, int64_t off)
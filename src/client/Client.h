@@ -77,6 +77,9 @@ enum {
   l_c_wrlat,
   l_c_read,
   l_c_fsync,
+  l_c_read_hit,
+  l_c_readahead,
+  l_c_readahead_waste,
   l_c_last,
 };
 
@@ -1350,11 +1353,11 @@ private:
 
   loff_t _lseek(Fh *fh, loff_t offset, int whence);
   int64_t _read(Fh *fh, int64_t offset, uint64_t size, bufferlist *bl);
-  int64_t _write(Fh *fh, int64_t offset, uint64_t size, const char *buf,
-          const struct iovec *iov, int iovcnt);
+  int64_t _write(Fh *fh, int64_t offset, uint64_t size, bufferlist& bl);
   int64_t _preadv_pwritev_locked(Fh *fh, const struct iovec *iov,
                                  unsigned iovcnt, int64_t offset,
-                                 bool write, bool clamp_to_int);
+                                 bool write, bool clamp_to_int,
+                                 bufferlist *wbl = nullptr);
   int _preadv_pwritev(int fd, const struct iovec *iov, unsigned iovcnt,
                       int64_t offset, bool write);
   int _flush(Fh *fh);
@@ -17,6 +17,7 @@ Readahead::Readahead()
     m_readahead_pos(0),
     m_readahead_trigger_pos(0),
     m_readahead_size(0),
+    m_wasted_bytes(0),
     m_pending(0) {
 }
 
@@ -54,6 +55,9 @@ void Readahead::_observe_read(uint64_t offset, uint64_t length) {
     m_nr_consec_read++;
     m_consec_read_bytes += length;
   } else {
+    if (m_readahead_pos > m_last_pos) {
+      m_wasted_bytes += m_readahead_pos - m_last_pos;
+    }
     m_nr_consec_read = 0;
     m_consec_read_bytes = 0;
     m_readahead_trigger_pos = 0;
@@ -194,3 +198,11 @@ void Readahead::set_alignments(const vector<uint64_t> &alignments) {
   m_alignments = alignments;
   m_lock.unlock();
 }
+
+uint64_t Readahead::take_wasted_bytes() {
+  m_lock.lock();
+  uint64_t wasted = m_wasted_bytes;
+  m_wasted_bytes = 0;
+  m_lock.unlock();
+  return wasted;
+}
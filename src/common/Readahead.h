@@ -108,6 +108,12 @@ public:
    */
   void set_alignments(const std::vector<uint64_t> &alignments);
 
+  /**
+     Returns the number of bytes read ahead that the stream never reached
+     because the access pattern changed, and resets the count.
+   */
+  uint64_t take_wasted_bytes();
+
 private:
   /**
      Records that a read request has been received.
@@ -154,6 +160,9 @@ private:
   /// Size of the next readahead request (barring changes due to alignment, etc.)
   uint64_t m_readahead_size;
 
+  /// Readahead bytes abandoned by pattern changes since take_wasted_bytes()
+  uint64_t m_wasted_bytes;
+
   /// Number of pending readahead requests, as determined by inc_pending() and dec_pending()
   int m_pending;
 
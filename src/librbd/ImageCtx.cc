@@ -285,6 +285,10 @@ librados::IoCtx duplicate_io_ctx(librados::IoCtx& io_ctx) {
     plb.add_u64_counter(l_librbd_readahead, "readahead", "Read ahead");
     plb.add_u64_counter(l_librbd_readahead_bytes, "readahead_bytes", "Data size in read ahead", NULL, 0, unit_t(UNIT_BYTES));
     plb.add_u64_counter(l_librbd_invalidate_cache, "invalidate_cache", "Cache invalidates");
+    plb.add_u64_counter(l_librbd_io_sched_delayed, "io_sched_delayed", "Writes delayed by the simple IO scheduler");
+    plb.add_u64_counter(l_librbd_io_sched_merged, "io_sched_merged", "Delayed writes merged into another write");
+    plb.add_u64_counter(l_librbd_io_sched_dispatched, "io_sched_dispatched", "Merged writes dispatched by the simple IO scheduler");
+    plb.add_time_avg(l_librbd_io_sched_delay, "io_sched_delay", "Delay applied by the simple IO scheduler");
 
     plb.add_time(l_librbd_opened_time, "opened_time", "Opened time",
                  "ots", perf_prio);
@@ -133,10 +133,7 @@ bool ObjectMap<I>::object_may_not_exist(uint64_t object_no) const
 }
 
 template <typename I>
-bool ObjectMap<I>::update_required(const ceph::BitVector<2>::Iterator& it,
-                                   uint8_t new_state) {
-  ceph_assert(ceph_mutex_is_locked(m_lock));
-  uint8_t state = *it;
+bool ObjectMap<I>::update_required(uint8_t state, uint8_t new_state) const {
   if ((state == new_state) ||
       (new_state == OBJECT_PENDING && state == OBJECT_NONEXISTENT) ||
       (new_state == OBJECT_NONEXISTENT && state != OBJECT_PENDING)) {
@@ -145,6 +142,28 @@ bool ObjectMap<I>::update_required(const ceph::BitVector<2>::Iterator& it,
   return true;
 }
 
+template <typename I>
+bool ObjectMap<I>::update_required(uint64_t start_object_no,
+                                   uint64_t end_object_no,
+                                   uint8_t new_state) const {
+  ceph_assert(ceph_mutex_is_locked(m_lock));
+  end_object_no = std::min(end_object_no, m_object_map.size());
+  if (start_object_no >= end_object_no) {
+    return false;
+  }
+
+  // only reads the map so that it can be used under a shared lock
+  const auto& object_map = m_object_map;
+  auto it = object_map.begin() + start_object_no;
+  auto end_it = object_map.begin() + end_object_no;
+  for (; it != end_it; ++it) {
+    if (update_required(*it, new_state)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 template <typename I>
 void ObjectMap<I>::open(Context *on_finish) {
   Context *ctx = create_context_callback<Context>(on_finish, this);
@@ -353,14 +372,7 @@ void ObjectMap<I>::aio_update(uint64_t snap_id, uint64_t start_object_no,
       return;
     }
 
-    auto it = m_object_map.begin() + start_object_no;
-    auto end_it = m_object_map.begin() + end_object_no;
-    for (; it != end_it; ++it) {
-      if (update_required(it, new_state)) {
-        break;
-      }
-    }
-    if (it == end_it) {
+    if (!update_required(start_object_no, end_object_no, new_state)) {
       ldout(cct, 20) << "object map update not required" << dendl;
       m_image_ctx.op_work_queue->queue(on_finish, 0);
       return;
@@ -82,26 +82,23 @@ public:
                   const ZTracer::Trace &parent_trace, bool ignore_enoent,
                   T *callback_object) {
     ceph_assert(start_object_no < end_object_no);
-    std::unique_lock locker{m_lock};
 
     if (snap_id == CEPH_NOSNAP) {
-      end_object_no = std::min(end_object_no, m_object_map.size());
-      if (start_object_no >= end_object_no) {
-        return false;
-      }
-
-      auto it = m_object_map.begin() + start_object_no;
-      auto end_it = m_object_map.begin() + end_object_no;
-      for (; it != end_it; ++it) {
-        if (update_required(it, new_state)) {
-          break;
+      {
+        // the objects are usually already in the requested state: avoid
+        // serializing concurrent IO behind the exclusive lock to check
+        std::shared_lock locker{m_lock};
+        if (!update_required(start_object_no, end_object_no, new_state)) {
+          return false;
         }
       }
 
-      if (it == end_it) {
+      std::unique_lock locker{m_lock};
+      if (!update_required(start_object_no, end_object_no, new_state)) {
         return false;
       }
 
+      end_object_no = std::min(end_object_no, m_object_map.size());
       m_async_op_tracker.start_op();
       UpdateOperation update_operation(start_object_no, end_object_no,
                                        new_state, current_state, parent_trace,
@@ -110,6 +107,7 @@ public:
                                          callback_object));
       detained_aio_update(std::move(update_operation));
     } else {
+      std::unique_lock locker{m_lock};
       aio_update(snap_id, start_object_no, end_object_no, new_state,
                  current_state, parent_trace, ignore_enoent,
                  util::create_context_callback<T, MF>(callback_object));
@@ -163,8 +161,9 @@ private:
                   const boost::optional<uint8_t> &current_state,
                   const ZTracer::Trace &parent_trace, bool ignore_enoent,
                   Context *on_finish);
-  bool update_required(const ceph::BitVector<2>::Iterator &it,
-                       uint8_t new_state);
+  bool update_required(uint8_t state, uint8_t new_state) const;
+  bool update_required(uint64_t start_object_no, uint64_t end_object_no,
+                       uint8_t new_state) const;
 
 };
 
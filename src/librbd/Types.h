@@ -52,6 +52,11 @@ enum {
 
   l_librbd_invalidate_cache,
 
+  l_librbd_io_sched_delayed,    // writes held back by the simple scheduler
+  l_librbd_io_sched_merged,     // delayed writes merged into another one
+  l_librbd_io_sched_dispatched, // merged writes sent after their delay
+  l_librbd_io_sched_delay,      // delay applied before dispatch
+
   l_librbd_opened_time,
   l_librbd_lock_acquired_time,
 
@@ -261,6 +261,8 @@ void AbstractWriteLog<I>::perf_start(std::string name) {
   plb.add_u64_counter(l_librbd_pwl_flush, "flush", "Flush (flush RWL)");
   plb.add_u64_counter(l_librbd_pwl_invalidate_cache, "invalidate", "Invalidate RWL");
   plb.add_u64_counter(l_librbd_pwl_invalidate_discard_cache, "discard", "Discard and invalidate RWL");
+  plb.add_u64_counter(l_librbd_pwl_wb_elided, "wb_elided", "Dirty writes overwritten before writeback");
+  plb.add_u64_counter(l_librbd_pwl_wb_elided_bytes, "wb_elided_bytes", "Writeback bytes avoided for overwritten writes");
 
   plb.add_time_avg(l_librbd_pwl_append_tx_t, "append_tx_lat", "Log append transaction latency");
   plb.add_u64_counter_histogram(
@@ -1622,6 +1624,46 @@ bool AbstractWriteLog<I>::can_flush_entry(std::shared_ptr<GenericLogEntry> log_e
          (m_flush_bytes_in_flight <= IN_FLIGHT_FLUSH_BYTES_LIMIT));
 }
 
+/* A dirty write whose whole extent has since been overwritten is no longer
+ * mapped anywhere, and nothing can read it back from the cache. Once every
+ * write now covering that extent has completed (i.e. is persistent in the
+ * log), replaying the log can never expose the old data either. If all of
+ * those writes also belong to its sync gen, no flush has ordered it before
+ * them, so it can be marked flushed without writing it back.
+ * Returns true if the entry was handled that way. */
+template <typename I>
+bool AbstractWriteLog<I>::elide_overwritten_entry(std::shared_ptr<GenericLogEntry> log_entry) {
+  ceph_assert(ceph_mutex_is_locked_by_me(m_lock));
+
+  if (m_invalidating || !log_entry->is_write_entry() ||
+      log_entry->ram_entry.sync_gen_number != m_current_sync_gen) {
+    return false;
+  }
+  auto write_entry = static_pointer_cast<GenericWriteLogEntry>(log_entry);
+  /* Overwriting writes replace the map entries as soon as they are set up,
+   * well before they are persisted. Look at what covers the extent now,
+   * under the map's own lock: any part still mapped to this entry can be
+   * read back, and parts whose overwriting entry was already retired have
+   * no map entry left, and were written back. */
+  WriteLogMapEntries map_entries = m_blocks_to_log_entries.find_map_entries(
+    write_entry->block_extent());
+  for (auto &map_entry : map_entries) {
+    if (map_entry.log_entry == write_entry ||
+        !map_entry.log_entry->completed) {
+      return false;
+    }
+  }
+
+  ldout(m_image_ctx.cct, 20) << "elided: " << log_entry << dendl;
+  ceph_assert(m_bytes_dirty >= log_entry->bytes_dirty());
+  log_entry->set_flushed(true);
+  m_bytes_dirty -= log_entry->bytes_dirty();
+  m_perfcounter->inc(l_librbd_pwl_wb_elided, 1);
+  m_perfcounter->inc(l_librbd_pwl_wb_elided_bytes, log_entry->bytes_dirty());
+  sync_point_writer_flushed(log_entry->get_sync_point_entry());
+  return true;
+}
+
 template <typename I>
 Context* AbstractWriteLog<I>::construct_flush_entry(std::shared_ptr<GenericLogEntry> log_entry,
                                                       bool invalidating) {
@@ -1701,6 +1743,10 @@ void AbstractWriteLog<I>::process_writeback_dirty_entries() {
       }
       auto candidate = m_dirty_log_entries.front();
       bool flushable = can_flush_entry(candidate);
+      if (flushable && elide_overwritten_entry(candidate)) {
+        m_dirty_log_entries.pop_front();
+        continue;
+      }
       if (flushable) {
         post_unlock.add(construct_flush_entry_ctx(candidate));
         flushed++;
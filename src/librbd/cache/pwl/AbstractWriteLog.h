@@ -237,6 +237,7 @@ private:
 
   void flush_dirty_entries(Context *on_finish);
   bool can_flush_entry(const std::shared_ptr<pwl::GenericLogEntry> log_entry);
+  bool elide_overwritten_entry(std::shared_ptr<pwl::GenericLogEntry> log_entry);
   bool handle_flushed_sync_point(
       std::shared_ptr<pwl::SyncPointLogEntry> log_entry);
   void sync_point_writer_flushed(
@@ -36,7 +36,7 @@ LogMapEntry<T>::LogMapEntry(std::shared_ptr<T> log_entry)
 template <typename T>
 LogMap<T>::LogMap(CephContext *cct)
   : m_cct(cct),
-    m_lock(ceph::make_mutex(pwl::unique_lock_name(
+    m_lock(ceph::make_shared_mutex(pwl::unique_lock_name(
            "librbd::cache::pwl::LogMap::m_lock", this))) {
 }
 
@@ -96,7 +96,7 @@ void LogMap<T>::remove_log_entries(std::list<std::shared_ptr<T>> &log_entries) {
  */
 template <typename T>
 std::list<std::shared_ptr<T>> LogMap<T>::find_log_entries(BlockExtent block_extent) {
-  std::lock_guard locker(m_lock);
+  std::shared_lock locker(m_lock);
   ldout(m_cct, 20) << dendl;
   return find_log_entries_locked(block_extent);
 }
@@ -107,116 +107,87 @@ std::list<std::shared_ptr<T>> LogMap<T>::find_log_entries(BlockExtent block_exte
  */
 template <typename T>
 LogMapEntries<T> LogMap<T>::find_map_entries(BlockExtent block_extent) {
-  std::lock_guard locker(m_lock);
+  std::shared_lock locker(m_lock);
   ldout(m_cct, 20) << dendl;
   return find_map_entries_locked(block_extent);
 }
 
+/*
+ * The overlapping map entries are contiguous in the set, so they are
+ * trimmed in a single pass over equal_range() instead of being looked up
+ * again one by one. Remainders sort just before the entry that followed
+ * the one they came from, so that iterator serves as the insertion hint.
+ */
 template <typename T>
 void LogMap<T>::add_log_entry_locked(std::shared_ptr<T> log_entry) {
   LogMapEntry<T> map_entry(log_entry);
   ldout(m_cct, 20) << "block_extent=" << map_entry.block_extent
                    << dendl;
-  ceph_assert(ceph_mutex_is_locked_by_me(m_lock));
-  LogMapEntries<T> overlap_entries = find_map_entries_locked(map_entry.block_extent);
-  for (auto &entry : overlap_entries) {
+  ceph_assert(ceph_mutex_is_wlocked(m_lock));
+  const BlockExtent &new_extent = map_entry.block_extent;
+  auto p = m_block_to_log_entry_map.equal_range(map_entry);
+  auto it = p.first;
+  while (it != p.second) {
+    LogMapEntry<T> entry = *it;
     ldout(m_cct, 20) << entry << dendl;
-    if (map_entry.block_extent.block_start <= entry.block_extent.block_start) {
-      if (map_entry.block_extent.block_end >= entry.block_extent.block_end) {
-        ldout(m_cct, 20) << "map entry completely occluded by new log entry" << dendl;
-        remove_map_entry_locked(entry);
-      } else {
-        ceph_assert(map_entry.block_extent.block_end < entry.block_extent.block_end);
-        /* The new entry occludes the beginning of the old entry */
-        BlockExtent adjusted_extent(map_entry.block_extent.block_end,
-                                    entry.block_extent.block_end);
-        adjust_map_entry_locked(entry, adjusted_extent);
-      }
-    } else {
-      if (map_entry.block_extent.block_end >= entry.block_extent.block_end) {
-        /* The new entry occludes the end of the old entry */
-        BlockExtent adjusted_extent(entry.block_extent.block_start,
-                                    map_entry.block_extent.block_start);
-        adjust_map_entry_locked(entry, adjusted_extent);
-      } else {
-        /* The new entry splits the old entry */
-        split_map_entry_locked(entry, map_entry.block_extent);
+    it = m_block_to_log_entry_map.erase(it);
+    bool keep_left = entry.block_extent.block_start < new_extent.block_start;
+    bool keep_right = entry.block_extent.block_end > new_extent.block_end;
+    if (keep_left) {
+      /* The new entry occludes the end of the old entry */
+      BlockExtent left_extent(entry.block_extent.block_start,
+                              new_extent.block_start);
+      m_block_to_log_entry_map.emplace_hint(it, left_extent, entry.log_entry);
+    }
+    if (keep_right) {
+      /* The new entry occludes the beginning of the old entry */
+      BlockExtent right_extent(new_extent.block_end,
+                               entry.block_extent.block_end);
+      m_block_to_log_entry_map.emplace_hint(it, right_extent, entry.log_entry);
+    }
+    if (keep_left && keep_right) {
+      /* The new entry splits the old entry */
+      entry.log_entry->inc_map_ref();
+    } else if (!keep_left && !keep_right) {
+      ldout(m_cct, 20) << "map entry completely occluded by new log entry" << dendl;
+      entry.log_entry->dec_map_ref();
+      if (0 == entry.log_entry->get_map_ref()) {
+        ldout(m_cct, 20) << "log entry has zero map entries: " << entry.log_entry << dendl;
       }
     }
   }
-  add_map_entry_locked(map_entry);
+  ceph_assert(map_entry.log_entry);
+  m_block_to_log_entry_map.insert(it, map_entry);
+  map_entry.log_entry->inc_map_ref();
 }
 
 template <typename T>
 void LogMap<T>::remove_log_entry_locked(std::shared_ptr<T> log_entry) {
   ldout(m_cct, 20) << "*log_entry=" << *log_entry << dendl;
-  ceph_assert(ceph_mutex_is_locked_by_me(m_lock));
-
-  LogMapEntries<T> possible_hits = find_map_entries_locked(log_entry->block_extent());
-  for (auto &possible_hit : possible_hits) {
-    if (possible_hit.log_entry == log_entry) {
-      /* This map entry refers to the specified log entry */
-      remove_map_entry_locked(possible_hit);
+  ceph_assert(ceph_mutex_is_wlocked(m_lock));
+
+  auto p = m_block_to_log_entry_map.equal_range(
+    LogMapEntry<T>(log_entry->block_extent()));
+  for (auto it = p.first; it != p.second; ) {
+    if (it->log_entry != log_entry) {
+      ++it;
+      continue;
+    }
+    /* This map entry refers to the specified log entry */
+    it = m_block_to_log_entry_map.erase(it);
+    log_entry->dec_map_ref();
+    if (0 == log_entry->get_map_ref()) {
+      ldout(m_cct, 20) << "log entry has zero map entries: " << log_entry << dendl;
     }
   }
 }
 
-template <typename T>
-void LogMap<T>::add_map_entry_locked(LogMapEntry<T> &map_entry) {
-  ceph_assert(map_entry.log_entry);
-  m_block_to_log_entry_map.insert(map_entry);
-  map_entry.log_entry->inc_map_ref();
-}
-
-template <typename T>
-void LogMap<T>::remove_map_entry_locked(LogMapEntry<T> &map_entry) {
-  auto it = m_block_to_log_entry_map.find(map_entry);
-  ceph_assert(it != m_block_to_log_entry_map.end());
-
-  LogMapEntry<T> erased = *it;
-  m_block_to_log_entry_map.erase(it);
-  erased.log_entry->dec_map_ref();
-  if (0 == erased.log_entry->get_map_ref()) {
-    ldout(m_cct, 20) << "log entry has zero map entries: " << erased.log_entry << dendl;
-  }
-}
-
-template <typename T>
-void LogMap<T>::adjust_map_entry_locked(LogMapEntry<T> &map_entry, BlockExtent &new_extent) {
-  auto it = m_block_to_log_entry_map.find(map_entry);
-  ceph_assert(it != m_block_to_log_entry_map.end());
-
-  LogMapEntry<T> adjusted = *it;
-  m_block_to_log_entry_map.erase(it);
-
-  m_block_to_log_entry_map.insert(LogMapEntry<T>(new_extent, adjusted.log_entry));
-}
-
-template <typename T>
-void LogMap<T>::split_map_entry_locked(LogMapEntry<T> &map_entry, BlockExtent &removed_extent) {
-  auto it = m_block_to_log_entry_map.find(map_entry);
-  ceph_assert(it != m_block_to_log_entry_map.end());
-
-  LogMapEntry<T> split = *it;
-  m_block_to_log_entry_map.erase(it);
-
-  BlockExtent left_extent(split.block_extent.block_start,
-                          removed_extent.block_start);
-  m_block_to_log_entry_map.insert(LogMapEntry<T>(left_extent, split.log_entry));
-
-  BlockExtent right_extent(removed_extent.block_end,
-                           split.block_extent.block_end);
-  m_block_to_log_entry_map.insert(LogMapEntry<T>(right_extent, split.log_entry));
-
-  split.log_entry->inc_map_ref();
-}
-
 template <typename T>
 std::list<std::shared_ptr<T>> LogMap<T>::find_log_entries_locked(const BlockExtent &block_extent) {
   std::list<std::shared_ptr<T>> overlaps;
   ldout(m_cct, 20) << "block_extent=" << block_extent << dendl;
 
-  ceph_assert(ceph_mutex_is_locked_by_me(m_lock));
+  ceph_assert(ceph_mutex_is_locked(m_lock));
   LogMapEntries<T> map_entries = find_map_entries_locked(block_extent);
   for (auto &map_entry : map_entries) {
     overlaps.emplace_back(map_entry.log_entry);
@@ -233,7 +204,7 @@ LogMapEntries<T> LogMap<T>::find_map_entries_locked(const BlockExtent &block_ext
   LogMapEntries<T> overlaps;
 
   ldout(m_cct, 20) << "block_extent=" << block_extent << dendl;
-  ceph_assert(ceph_mutex_is_locked_by_me(m_lock));
+  ceph_assert(ceph_mutex_is_locked(m_lock));
   auto p = m_block_to_log_entry_map.equal_range(LogMapEntry<T>(block_extent));
   ldout(m_cct, 20) << "count=" << std::distance(p.first, p.second) << dendl;
   for ( auto i = p.first; i != p.second; ++i ) {
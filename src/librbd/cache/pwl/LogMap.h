@@ -51,10 +51,6 @@ public:
 private:
   void add_log_entry_locked(std::shared_ptr<T> log_entry);
   void remove_log_entry_locked(std::shared_ptr<T> log_entry);
-  void add_map_entry_locked(LogMapEntry<T> &map_entry);
-  void remove_map_entry_locked(LogMapEntry<T> &map_entry);
-  void adjust_map_entry_locked(LogMapEntry<T> &map_entry, BlockExtent &new_extent);
-  void split_map_entry_locked(LogMapEntry<T> &map_entry, BlockExtent &removed_extent);
   std::list<std::shared_ptr<T>> find_log_entries_locked(const BlockExtent &block_extent);
   LogMapEntries<T> find_map_entries_locked(const BlockExtent &block_extent);
 
@@ -70,7 +66,8 @@ private:
                                               LogMapEntryCompare>;
 
   CephContext *m_cct;
-  ceph::mutex m_lock;
+  /* lookups from the read path only need shared access */
+  ceph::shared_mutex m_lock;
   BlockExtentToLogMapEntries m_block_to_log_entry_map;
 };
 
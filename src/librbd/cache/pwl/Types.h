@@ -140,6 +140,8 @@ enum {
   l_librbd_pwl_flush,
   l_librbd_pwl_invalidate_cache,
   l_librbd_pwl_invalidate_discard_cache,
+  l_librbd_pwl_wb_elided,          // dirty writes dropped because later writes covered them
+  l_librbd_pwl_wb_elided_bytes,    // bytes of writeback avoided that way
 
   l_librbd_pwl_append_tx_t,
   l_librbd_pwl_retire_tx_t,
@@ -68,6 +68,7 @@ int BlockCrypto<T>::crypt(ceph::bufferlist* data, uint64_t image_offset,
         auto r = m_data_cryptor->init_context(ctx, iv, m_iv_size);
         if (r != 0) {
           lderr(m_cct) << "unable to init cipher's IV" << dendl;
+          m_data_cryptor->return_context(ctx, mode);
           return r;
         }
 
@@ -100,6 +101,7 @@ int BlockCrypto<T>::crypt(ceph::bufferlist* data, uint64_t image_offset,
 
       if (crypto_output_length < 0) {
         lderr(m_cct) << "crypt update failed" << dendl;
+        m_data_cryptor->return_context(ctx, mode);
         return crypto_output_length;
       }
 
@@ -2,6 +2,7 @@
 // vim: ts=8 sw=2 smarttab
 
 #include "librbd/crypto/CryptoContextPool.h"
+#include "librbd/crypto/openssl/DataCryptor.h"
 
 namespace librbd {
 namespace crypto {
@@ -22,6 +23,7 @@ CryptoContextPool<T>::~CryptoContextPool() {
   while (m_decrypt_contexts.pop(ctx)) {
     m_data_cryptor->return_context(ctx, CipherMode::CIPHER_MODE_DEC);
   }
+  delete m_data_cryptor;
 }
 
 template <typename T>
@@ -35,10 +37,12 @@ T* CryptoContextPool<T>::get_context(CipherMode mode) {
 
 template <typename T>
 void CryptoContextPool<T>::return_context(T* ctx, CipherMode mode) {
-  if (!get_contexts(mode).push(ctx)) {
+  if (!get_contexts(mode).bounded_push(ctx)) {
     m_data_cryptor->return_context(ctx, mode);
   }
 }
 
 } // namespace crypto
 } // namespace librbd
+
+template class librbd::crypto::CryptoContextPool<EVP_CIPHER_CTX>;
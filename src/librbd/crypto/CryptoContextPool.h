@@ -15,6 +15,7 @@ template <typename T>
 class CryptoContextPool : public DataCryptor<T>  {
 
 public:
+    // takes ownership of data_cryptor
     CryptoContextPool(DataCryptor<T>* data_cryptor, uint32_t pool_size);
     ~CryptoContextPool();
 
@@ -94,6 +94,7 @@ EVP_CIPHER_CTX* DataCryptor::get_context(CipherMode mode) {
   if (1 != EVP_CipherInit_ex(ctx, m_cipher, nullptr, m_key, nullptr, enc)) {
     lderr(m_cct) << "EVP_CipherInit_ex failed" << dendl;
     log_errors();
+    EVP_CIPHER_CTX_free(ctx);
     return nullptr;
   }
 
@@ -138,43 +138,50 @@ void ObjectCopyRequest<I>::send_read() {
     return;
   }
 
-  auto index = *m_read_snaps.begin();
-  auto& read_op = m_read_ops[index];
-  if (read_op.image_interval.empty()) {
-    // nothing written to this object for this snapshot (must be trunc/remove)
-    handle_read(0);
-    return;
-  }
+  // each snapshot is read into its own read op and the results are only
+  // combined by merge_write_ops(), so all the reads can be in flight at once
+  auto ctx = create_context_callback<
+    ObjectCopyRequest<I>, &ObjectCopyRequest<I>::handle_read>(this);
+  auto gather_ctx = new C_Gather(m_cct, ctx);
 
-  auto io_context = m_src_image_ctx->duplicate_data_io_context();
-  io_context->read_snap(index.second);
+  for (auto& index : m_read_snaps) {
+    auto& read_op = m_read_ops[index];
+    if (read_op.image_interval.empty()) {
+      // nothing written to this object for this snapshot (must be trunc/remove)
+      continue;
+    }
 
-  io::Extents image_extents{read_op.image_interval.begin(),
-                            read_op.image_interval.end()};
-  io::ReadResult read_result{&read_op.image_extent_map,
-                             &read_op.out_bl};
+    auto io_context = m_src_image_ctx->duplicate_data_io_context();
+    io_context->read_snap(index.second);
 
-  ldout(m_cct, 20) << "read: src_snap_seq=" << index.second << ", "
-                   << "image_extents=" << image_extents << dendl;
+    io::Extents image_extents{read_op.image_interval.begin(),
+                              read_op.image_interval.end()};
+    io::ReadResult read_result{&read_op.image_extent_map,
+                               &read_op.out_bl};
 
-  int op_flags = (LIBRADOS_OP_FLAG_FADVISE_SEQUENTIAL |
-                  LIBRADOS_OP_FLAG_FADVISE_NOCACHE);
+    ldout(m_cct, 20) << "read: src_snap_seq=" << index.second << ", "
+                     << "image_extents=" << image_extents << dendl;
 
-  int read_flags = 0;
-  if (index.second != m_src_image_ctx->snap_id) {
-    read_flags |= io::READ_FLAG_DISABLE_CLIPPING;
-  }
+    int op_flags = (LIBRADOS_OP_FLAG_FADVISE_SEQUENTIAL |
+                    LIBRADOS_OP_FLAG_FADVISE_NOCACHE);
 
-  auto ctx = create_context_callback<
-    ObjectCopyRequest<I>, &ObjectCopyRequest<I>::handle_read>(this);
-  auto aio_comp = io::AioCompletion::create_and_start(
-    ctx, get_image_ctx(m_src_image_ctx), io::AIO_TYPE_READ);
+    int read_flags = 0;
+    if (index.second != m_src_image_ctx->snap_id) {
+      read_flags |= io::READ_FLAG_DISABLE_CLIPPING;
+    }
 
-  auto req = io::ImageDispatchSpec::create_read(
-    *m_src_image_ctx, io::IMAGE_DISPATCH_LAYER_INTERNAL_START, aio_comp,
-    std::move(image_extents), std::move(read_result), io_context, op_flags,
-    read_flags, {});
-  req->send();
+    auto aio_comp = io::AioCompletion::create_and_start(
+      gather_ctx->new_sub(), get_image_ctx(m_src_image_ctx),
+      io::AIO_TYPE_READ);
+
+    auto req = io::ImageDispatchSpec::create_read(
+      *m_src_image_ctx, io::IMAGE_DISPATCH_LAYER_INTERNAL_START, aio_comp,
+      std::move(image_extents), std::move(read_result), io_context, op_flags,
+      read_flags, {});
+    req->send();
+  }
+
+  gather_ctx->activate();
 }
 
 template <typename I>
@@ -189,14 +196,12 @@ void ObjectCopyRequest<I>::handle_read(int r) {
   }
 
   if (m_handler != nullptr) {
-    auto index = *m_read_snaps.begin();
-    auto& read_op = m_read_ops[index];
-    m_handler->handle_read(read_op.out_bl.length());
+    for (auto& index : m_read_snaps) {
+      m_handler->handle_read(m_read_ops[index].out_bl.length());
+    }
   }
 
-  ceph_assert(!m_read_snaps.empty());
-  m_read_snaps.erase(m_read_snaps.begin());
-
+  m_read_snaps.clear();
   send_read();
 }
 
@@ -54,7 +54,7 @@ public:
     auto count = rolling_count(m_acc);
 
     if (count > 0) {
-      return rolling_sum(m_acc);
+      return rolling_sum(m_acc) / count;
     }
     return 0;
   }
@@ -65,9 +65,10 @@ bool SimpleSchedulerObjectDispatch<I>::ObjectRequests::try_delay_request(
     uint64_t object_off, ceph::bufferlist&& data, IOContext io_context,
     int op_flags, int object_dispatch_flags, Context* on_dispatched) {
   if (!m_delayed_requests.empty()) {
+    // a delayed zero length write covers the whole object
     if (!m_io_context || *m_io_context != *io_context ||
         op_flags != m_op_flags || data.length() == 0 ||
-        intersects(object_off, data.length())) {
+        m_delayed_requests.begin()->second.data.length() == 0) {
       return false;
     }
   } else {
@@ -81,42 +82,49 @@ bool SimpleSchedulerObjectDispatch<I>::ObjectRequests::try_delay_request(
     ceph_assert(m_delayed_requests.empty());
     m_delayed_request_extents.insert(0, UINT64_MAX);
   } else {
-    m_delayed_request_extents.insert(object_off, data.length());
+    m_delayed_request_extents.union_insert(object_off, data.length());
   }
   m_object_dispatch_flags |= object_dispatch_flags;
 
   if (!m_delayed_requests.empty()) {
-    // try to merge front to an existing request
-    auto iter = m_delayed_requests.find(object_off + data.length());
-    if (iter != m_delayed_requests.end()) {
-      auto new_iter = m_delayed_requests.insert({object_off, {}}).first;
-      new_iter->second.data = std::move(data);
-      new_iter->second.data.append(std::move(iter->second.data));
-      new_iter->second.requests = std::move(iter->second.requests);
-      new_iter->second.requests.push_back(on_dispatched);
-      m_delayed_requests.erase(iter);
-
-      if (new_iter != m_delayed_requests.begin()) {
-        auto prev = new_iter;
-        try_merge_delayed_requests(--prev, new_iter);
+    // find the delayed requests this one overlaps or touches; they are
+    // disjoint and sorted, so they form the range [first, last)
+    uint64_t object_end = object_off + data.length();
+    auto first = m_delayed_requests.lower_bound(object_off);
+    if (first != m_delayed_requests.begin()) {
+      auto prev = std::prev(first);
+      if (prev->first + prev->second.data.length() >= object_off) {
+        first = prev;
       }
-      return true;
     }
+    auto last = m_delayed_requests.upper_bound(object_end);
+
+    if (first != last) {
+      // the new data replaces whatever it overlaps: keep the head of the
+      // first request and the tail of the last one around it
+      MergedRequests merged;
+      uint64_t merged_off = std::min(first->first, object_off);
+      if (first->first < object_off) {
+        merged.data.substr_of(first->second.data, 0,
+                              object_off - first->first);
+      }
+      merged.data.claim_append(data);
+
+      auto back = std::prev(last);
+      uint64_t back_end = back->first + back->second.data.length();
+      if (back_end > object_end) {
+        ceph::bufferlist tail;
+        tail.substr_of(back->second.data, object_end - back->first,
+                       back_end - object_end);
+        merged.data.claim_append(tail);
+      }
 
-    // try to merge back to an existing request
-    iter = m_delayed_requests.lower_bound(object_off);
-    if (iter == m_delayed_requests.end() || iter->first > object_off) {
-      iter--;
-    }
-    if (iter != m_delayed_requests.end() &&
-        iter->first + iter->second.data.length() == object_off) {
-      iter->second.data.append(std::move(data));
-      iter->second.requests.push_back(on_dispatched);
-
-      auto next = iter;
-      if (++next != m_delayed_requests.end()) {
-        try_merge_delayed_requests(iter, next);
+      for (auto it = first; it != last; ++it) {
+        merged.requests.splice(merged.requests.end(), it->second.requests);
       }
+      merged.requests.push_back(on_dispatched);
+      m_delayed_requests.erase(first, last);
+      m_delayed_requests.emplace(merged_off, std::move(merged));
       return true;
     }
   }
@@ -128,21 +136,6 @@ bool SimpleSchedulerObjectDispatch<I>::ObjectRequests::try_delay_request(
   return true;
 }
 
-template <typename I>
-void SimpleSchedulerObjectDispatch<I>::ObjectRequests::try_merge_delayed_requests(
-    typename std::map<uint64_t, MergedRequests>::iterator &iter1,
-    typename std::map<uint64_t, MergedRequests>::iterator &iter2) {
-  if (iter1->first + iter1->second.data.length() != iter2->first) {
-    return;
-  }
-
-  iter1->second.data.append(std::move(iter2->second.data));
-  iter1->second.requests.insert(iter1->second.requests.end(),
-                                iter2->second.requests.begin(),
-                                iter2->second.requests.end());
-  m_delayed_requests.erase(iter2);
-}
-
 template <typename I>
 void SimpleSchedulerObjectDispatch<I>::ObjectRequests::dispatch_delayed_requests(
     I *image_ctx, LatencyStats *latency_stats, ceph::mutex *latency_stats_lock) {
@@ -150,6 +143,10 @@ void SimpleSchedulerObjectDispatch<I>::ObjectRequests::dispatch_delayed_requests
     auto offset = it.first;
     auto &merged_requests = it.second;
 
+    image_ctx->perfcounter->inc(l_librbd_io_sched_dispatched);
+    image_ctx->perfcounter->inc(l_librbd_io_sched_merged,
+                                merged_requests.requests.size() - 1);
+
     auto ctx = new LambdaContext(
         [requests=std::move(merged_requests.requests), latency_stats,
          latency_stats_lock, start_time=ceph_clock_now()](int r) {
@@ -396,16 +393,20 @@ bool SimpleSchedulerObjectDispatch<I>::try_delay_write(
       on_dispatched);
 
   ldout(cct, 20) << "delayed: " << delayed << dendl;
+  if (delayed) {
+    m_image_ctx->perfcounter->inc(l_librbd_io_sched_delayed);
+  }
 
   // schedule dispatch on the first request added
   if (delayed && !object_requests->is_scheduled_dispatch()) {
-    auto dispatch_time = ceph::real_clock::now();
+    ceph::timespan delay;
     if (m_latency_stats) {
-      dispatch_time += std::chrono::nanoseconds(m_latency_stats->avg() / 2);
+      delay = std::chrono::nanoseconds(m_latency_stats->avg() / 2);
     } else {
-      dispatch_time += std::chrono::milliseconds(m_max_delay);
+      delay = std::chrono::milliseconds(m_max_delay);
     }
-    object_requests->set_scheduled_dispatch(dispatch_time);
+    m_image_ctx->perfcounter->tinc(l_librbd_io_sched_delay, delay);
+    object_requests->set_scheduled_dispatch(ceph::real_clock::now() + delay);
     m_dispatch_queue.push_back(object_requests);
     if (m_dispatch_queue.front() == object_requests) {
       schedule_dispatch_delayed_requests();
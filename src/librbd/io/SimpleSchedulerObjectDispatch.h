@@ -180,10 +180,6 @@ private:
     int m_object_dispatch_flags = 0;
     std::map<uint64_t, MergedRequests> m_delayed_requests;
     interval_set<uint64_t> m_delayed_request_extents;
-
-    void try_merge_delayed_requests(
-        typename std::map<uint64_t, MergedRequests>::iterator &iter,
-        typename std::map<uint64_t, MergedRequests>::iterator &iter2);
   };
 
   typedef std::shared_ptr<ObjectRequests> ObjectRequestsRef;
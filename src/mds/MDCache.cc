@@ -6644,6 +6644,17 @@ std::pair<bool, uint64_t> MDCache::trim_lru(uint64_t count, expiremap& expiremap
   uint64_t trimmed = 0;
 
   auto trim_threshold = g_conf().get_val<Option::size_t>("mds_cache_trim_threshold");
+  auto max_duration = g_conf().get_val<std::chrono::milliseconds>("mds_cache_trim_max_duration");
+  auto start = mono_clock::now();
+  trim_deadline_hit = false;
+  // checking the clock for every dentry would be wasteful
+  auto out_of_time = [&]() {
+    if (max_duration.count() > 0 && (trimmed + unexpirables.size()) % 64 == 63 &&
+        mono_clock::now() - start >= max_duration) {
+      trim_deadline_hit = true;
+    }
+    return trim_deadline_hit;
+  };
 
   dout(7) << "trim_lru trimming " << count
           << " items from LRU"
@@ -6656,7 +6667,7 @@ std::pair<bool, uint64_t> MDCache::trim_lru(uint64_t count, expiremap& expiremap
   const uint64_t trim_counter_start = trim_counter.get();
   bool throttled = false;
   while (1) {
-    throttled |= trim_counter_start+trimmed >= trim_threshold;
+    throttled |= trim_counter_start+trimmed >= trim_threshold || out_of_time();
     if (throttled) break;
     CDentry *dn = static_cast<CDentry*>(bottom_lru.lru_expire());
     if (!dn)
@@ -6676,7 +6687,7 @@ std::pair<bool, uint64_t> MDCache::trim_lru(uint64_t count, expiremap& expiremap
   // trim dentries from the LRU until count is reached
   // if mds is in standby_replay and skip trimming the inodes
   while (!throttled && (cache_toofull() || count > 0 || is_standby_replay)) {
-    throttled |= trim_counter_start+trimmed >= trim_threshold;
+    throttled |= trim_counter_start+trimmed >= trim_threshold || out_of_time();
     if (throttled) break;
     CDentry *dn = static_cast<CDentry*>(lru.lru_expire());
     if (!dn) {
@@ -6701,10 +6712,51 @@ std::pair<bool, uint64_t> MDCache::trim_lru(uint64_t count, expiremap& expiremap
   }
   unexpirables.clear();
 
-  dout(7) << "trim_lru trimmed " << trimmed << " items" << dendl;
+  auto duration = mono_clock::now() - start;
+  if (logger) {
+    logger->tinc(l_mdc_trim_lat, duration);
+    if (trim_deadline_hit) {
+      logger->inc(l_mdc_trim_deadline);
+    }
+  }
+
+  dout(7) << "trim_lru trimmed " << trimmed << " items in " << duration
+          << (trim_deadline_hit ? " (out of time)" : "") << dendl;
   return std::pair<bool, uint64_t>(throttled, trimmed);
 }
 
+class C_MDC_Retrim : public MDCacheContext {
+public:
+  explicit C_MDC_Retrim(MDCache *m) : MDCacheContext(m) {}
+  void finish(int) override {
+    mdcache->retrim();
+  }
+};
+
+void MDCache::queue_retrim()
+{
+  ceph_assert(ceph_mutex_is_locked_by_me(mds->mds_lock));
+  if (!trim_deadline_hit || retrim_queued)
+    return;
+  /* the timer runs its callbacks under mds_lock and would take it right
+   * back after an immediate event, so leave mds_lock free for as long as
+   * the pass that was cut short held it before trimming again */
+  auto delay = g_conf().get_val<std::chrono::milliseconds>("mds_cache_trim_max_duration");
+  dout(20) << "queueing retrim in " << delay << dendl;
+  retrim_queued = true;
+  mds->timer.add_event_after(ceph::timespan(delay), new C_MDC_Retrim(this));
+}
+
+void MDCache::retrim()
+{
+  retrim_queued = false;
+  if (!mds->is_cache_trimmable())
+    return;
+  dout(20) << "resuming trim cut short by mds_cache_trim_max_duration" << dendl;
+  trim();
+  queue_retrim();
+}
+
 /*
  * note: only called while MDS is active or stopping... NOT during recovery.
  * however, we may expire a replica whose authority is recovering.
@@ -13142,6 +13194,12 @@ void MDCache::register_perfcounters()
     pcb.add_u64_counter(l_mdss_ireq_inodestats, "ireq_inodestats",
                         "Internal Request type inode stats");
 
+    // cache trimming
+    pcb.add_time_avg(l_mdc_trim_lat, "trim_lat",
+                     "Time spent trimming the cache LRU");
+    pcb.add_u64_counter(l_mdc_trim_deadline, "trim_deadline",
+                        "Cache trims stopped on mds_cache_trim_max_duration");
+
     logger.reset(pcb.create_perf_counters());
     g_ceph_context->get_perfcounters_collection()->add(logger.get());
     recovery_queue.set_logger(logger.get());
@@ -13271,6 +13329,7 @@ void MDCache::upkeep_main(void)
           trim_client_leases();
         }
         trim();
+        queue_retrim();
         if (active_with_clients) {
           auto recall_flags = Server::RecallFlags::ENFORCE_MAX|Server::RecallFlags::ENFORCE_LIVENESS;
           if (cache_toofull()) {
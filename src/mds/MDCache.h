@@ -106,6 +106,11 @@ enum {
   l_mdss_ireq_fragstats,
   l_mdss_ireq_inodestats,
 
+  // Time spent trimming the cache LRU under mds_lock
+  l_mdc_trim_lat,
+  // How many LRU trims stopped early on mds_cache_trim_max_duration
+  l_mdc_trim_deadline,
+
   l_mdc_last,
 };
 
@@ -610,6 +615,7 @@ class MDCache {
 
   // trimming
   std::pair<bool, uint64_t> trim(uint64_t count=0);
+  void retrim();
 
   bool trim_non_auth_subtree(CDir *directory);
   void standby_trim_segment(LogSegment *ls);
@@ -1333,6 +1339,11 @@ class MDCache {
   map<dirfrag_t,fragment_info_t> fragments;
 
   DecayCounter trim_counter;
+  // set when the last trim_lru() ran out of time before finishing
+  bool trim_deadline_hit = false;
+  // a timer event is pending to resume a trim that ran out of time
+  bool retrim_queued = false;
+  void queue_retrim();
 
   std::thread upkeeper;
   ceph::mutex upkeep_mutex = ceph::make_mutex("MDCache::upkeep_mutex");
@@ -36,6 +36,9 @@
 #undef dout_prefix
 #define dout_prefix *_dout << "mds." << mds->get_nodeid() << ".log "
 
+// journal events decoded ahead of replay, applied under one mds_lock hold
+static constexpr size_t REPLAY_BATCH = 64;
+
 // cons/des
 MDLog::~MDLog()
 {
@@ -67,6 +70,7 @@ void MDLog::create_logger()
   plb.add_u64_counter(l_mdl_replayed, "replayed", "Events replayed",
 		      "repl", PerfCountersBuilder::PRIO_INTERESTING);
   plb.add_time_avg(l_mdl_jlat, "jlat", "Journaler flush latency");
+  plb.add_u64_avg(l_mdl_flushev, "flushev", "Events per journal flush");
   plb.add_u64_counter(l_mdl_evex, "evex", "Total expired events");
   plb.add_u64_counter(l_mdl_evtrm, "evtrm", "Trimmed events");
   plb.add_u64_counter(l_mdl_segadd, "segadd", "Segments added");
@@ -356,6 +360,9 @@ void MDLog::_submit_thread()
 
   std::unique_lock locker{submit_mutex};
 
+  // events appended since the last journal flush
+  uint64_t unflushed_events = 0;
+
   while (!mds->is_daemon_stopping()) {
     if (g_conf()->mds_log_pause) {
       submit_cond.wait(locker);
@@ -373,68 +380,83 @@ void MDLog::_submit_thread()
       continue;
     }
 
+    // take everything queued for this segment at once, so that a burst of
+    // submissions costs one round trip on submit_mutex and one flush. the
+    // emptied list stays in pending_events until the next pass, so trim()
+    // keeps treating the segment as having unjournaled events meanwhile.
     int64_t features = mdsmap_up_features;
-    PendingEvent data = it->second.front();
-    it->second.pop_front();
+    list<PendingEvent> batch;
+    batch.swap(it->second);
 
     locker.unlock();
 
-    if (data.le) {
-      LogEvent *le = data.le;
-      LogSegment *ls = le->_segment;
-      // encode it, with event type
-      bufferlist bl;
-      le->encode_with_header(bl, features);
-
-      uint64_t write_pos = journaler->get_write_pos();
+    bool flush = false;
+    for (auto& data : batch) {
+      if (data.le) {
+	LogEvent *le = data.le;
+	LogSegment *ls = le->_segment;
+	// encode it, with event type
+	bufferlist bl;
+	le->encode_with_header(bl, features);
 
-      le->set_start_off(write_pos);
-      if (le->get_type() == EVENT_SUBTREEMAP)
-	ls->offset = write_pos;
+	uint64_t write_pos = journaler->get_write_pos();
 
-      dout(5) << "_submit_thread " << write_pos << "~" << bl.length()
-	      << " : " << *le << dendl;
+	le->set_start_off(write_pos);
+	if (le->get_type() == EVENT_SUBTREEMAP)
+	  ls->offset = write_pos;
 
-      // journal it.
-      const uint64_t new_write_pos = journaler->append_entry(bl);  // bl is destroyed.
-      ls->end = new_write_pos;
+	dout(5) << "_submit_thread " << write_pos << "~" << bl.length()
+		<< " : " << *le << dendl;
 
-      MDSLogContextBase *fin;
-      if (data.fin) {
-	fin = dynamic_cast<MDSLogContextBase*>(data.fin);
-	ceph_assert(fin);
-	fin->set_write_pos(new_write_pos);
-      } else {
-	fin = new C_MDL_Flushed(this, new_write_pos);
-      }
+	// journal it.
+	const uint64_t new_write_pos = journaler->append_entry(bl);  // bl is destroyed.
+	ls->end = new_write_pos;
 
-      journaler->wait_for_flush(fin);
+	MDSLogContextBase *fin;
+	if (data.fin) {
+	  fin = dynamic_cast<MDSLogContextBase*>(data.fin);
+	  ceph_assert(fin);
+	  fin->set_write_pos(new_write_pos);
+	} else {
+	  fin = new C_MDL_Flushed(this, new_write_pos);
+	}
 
-      if (data.flush)
-	journaler->flush();
+	journaler->wait_for_flush(fin);
+	unflushed_events++;
 
-      if (logger)
-	logger->set(l_mdl_wrpos, ls->end);
+	if (logger)
+	  logger->set(l_mdl_wrpos, ls->end);
 
-      delete le;
-    } else {
-      if (data.fin) {
-	MDSContext* fin =
-		dynamic_cast<MDSContext*>(data.fin);
-	ceph_assert(fin);
-	C_MDL_Flushed *fin2 = new C_MDL_Flushed(this, fin);
-	fin2->set_write_pos(journaler->get_write_pos());
-	journaler->wait_for_flush(fin2);
+	delete le;
+      } else {
+	if (data.fin) {
+	  MDSContext* fin =
+		  dynamic_cast<MDSContext*>(data.fin);
+	  ceph_assert(fin);
+	  C_MDL_Flushed *fin2 = new C_MDL_Flushed(this, fin);
+	  fin2->set_write_pos(journaler->get_write_pos());
+	  journaler->wait_for_flush(fin2);
+	}
       }
-      if (data.flush)
-	journaler->flush();
+      flush |= data.flush;
+    }
+
+    // a flush covers everything appended before it, so one flush after
+    // the whole batch satisfies every flush request in it
+    if (flush) {
+      journaler->flush();
+      if (logger)
+	logger->inc(l_mdl_flushev, unflushed_events);
+      unflushed_events = 0;
     }
 
     locker.lock();
-    if (data.flush)
-      unflushed = 0;
-    else if (data.le)
-      unflushed++;
+    for (const auto& data : batch) {
+      if (data.flush)
+	unflushed = 0;
+      else if (data.le)
+	unflushed++;
+    }
   }
 }
 
@@ -1300,9 +1322,41 @@ void MDLog::_replay_thread()
 {
   dout(10) << "_replay_thread start" << dendl;
 
+  // decoded events waiting to be replayed. they are applied in batches so
+  // that mds_lock is taken once per batch rather than once per event.
+  std::vector<std::unique_ptr<LogEvent>> decoded;
+  auto replay_decoded = [this, &decoded]() {
+    if (decoded.empty()) {
+      return true;
+    }
+    {
+      std::lock_guard l(mds->mds_lock);
+      if (mds->is_daemon_stopping()) {
+        return false;
+      }
+      for (auto& le : decoded) {
+        logger->inc(l_mdl_replayed);
+        le->replay(mds);
+      }
+    }
+    decoded.clear();
+    return true;
+  };
+
+  auto start = mono_clock::now();
+  uint64_t replayed_events = num_events;
+
   // loop
   int r = 0;
   while (1) {
+    // replay what we have before waiting for more, or before an error
+    // path touches the segments
+    if (decoded.size() >= REPLAY_BATCH || !journaler->is_readable()) {
+      if (!replay_decoded()) {
+        return;
+      }
+    }
+
     // wait for read?
     while (!journaler->is_readable() &&
 	   journaler->get_read_pos() < journaler->get_write_pos() &&
@@ -1432,24 +1486,25 @@ void MDLog::_replay_thread()
       le->_segment->end = journaler->get_read_pos();
       num_events++;
 
-      {
-        std::lock_guard l(mds->mds_lock);
-        if (mds->is_daemon_stopping()) {
-          return;
-        }
-        logger->inc(l_mdl_replayed);
-        le->replay(mds);
-      }
+      decoded.push_back(std::move(le));
     }
 
     logger->set(l_mdl_rdpos, pos);
   }
 
+  if (!replay_decoded()) {
+    return;
+  }
+
   // done!
   if (r == 0) {
     ceph_assert(journaler->get_read_pos() == journaler->get_write_pos());
+    std::chrono::duration<double> elapsed = mono_clock::now() - start;
+    replayed_events = num_events - replayed_events;
     dout(10) << "_replay - complete, " << num_events
-	     << " events" << dendl;
+	     << " events, replayed " << replayed_events << " in " << elapsed.count()
+	     << "s (" << (elapsed.count() > 0 ? replayed_events / elapsed.count() : 0)
+	     << " events/s)" << dendl;
 
     logger->set(l_mdl_expos, journaler->get_expire_pos());
   }
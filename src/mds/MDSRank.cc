@@ -1063,13 +1063,6 @@ bool MDSRank::_dispatch(const cref_t<Message> &m, bool new_msg)
   }
 
   // hack: thrash exports
-  static utime_t start;
-  utime_t now = ceph_clock_now();
-  if (start == utime_t())
-    start = now;
-  /*double el = now - start;
-  if (el > 30.0 &&
-    el < 60.0)*/
   for (int i=0; i<g_conf()->mds_thrash_exports; i++) {
     set<mds_rank_t> s;
     if (!is_active()) break;
@@ -1135,7 +1128,6 @@ bool MDSRank::_dispatch(const cref_t<Message> &m, bool new_msg)
   }
   */
 
-  update_mlogger();
   return true;
 }
 
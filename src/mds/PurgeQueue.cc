@@ -144,6 +144,9 @@ void PurgeQueue::create_logger()
   pcb.add_u64(l_pq_executing, "pq_executing", "Purge queue tasks in flight");
   pcb.add_u64(l_pq_executing_high_water, "pq_executing_high_water", "Maximum number of executing file purges");
   pcb.add_u64(l_pq_item_in_journal, "pq_item_in_journal", "Purge item left in journal");
+  pcb.add_u64_counter(l_pq_executed_bytes, "pq_executed_bytes", "Purge queue file bytes purged");
+  pcb.add_time_avg(l_pq_item_age, "pq_item_age", "Time purge items spent queued before execution");
+  pcb.add_u64(l_pq_executing_ops_limit, "pq_executing_ops_limit", "Purge ops currently allowed in flight");
 
   logger.reset(pcb.create_perf_counters());
   g_ceph_context->get_perfcounters_collection()->add(logger.get());
@@ -391,7 +394,8 @@ bool PurgeQueue::_can_consume()
     return false;
   }
 
-  dout(20) << ops_in_flight << "/" << max_purge_ops << " ops, "
+  const uint64_t op_limit = _op_limit();
+  dout(20) << ops_in_flight << "/" << op_limit << " ops, "
            << in_flight.size() << "/" << g_conf()->mds_max_purge_files
            << " files" << dendl;
 
@@ -403,9 +407,9 @@ bool PurgeQueue::_can_consume()
     return true;
   }
 
-  if (ops_in_flight >= max_purge_ops) {
+  if (ops_in_flight >= op_limit) {
     dout(20) << "Throttling on op limit " << ops_in_flight << "/"
-             << max_purge_ops << dendl;
+             << op_limit << dendl;
     return false;
   }
 
@@ -418,6 +422,54 @@ bool PurgeQueue::_can_consume()
   }
 }
 
+uint64_t PurgeQueue::_op_limit() const
+{
+  if (draining ||
+      cct->_conf.get_val<std::chrono::milliseconds>(
+        "mds_purge_target_latency").count() == 0) {
+    return max_purge_ops;
+  }
+  return std::min(purge_ops_window, max_purge_ops);
+}
+
+void PurgeQueue::_update_op_window(const PurgeItem &item, ceph::timespan lat)
+{
+  ceph_assert(ceph_mutex_is_locked_by_me(lock));
+
+  const ceph::timespan target = cct->_conf.get_val<std::chrono::milliseconds>(
+    "mds_purge_target_latency");
+  if (target == ceph::timespan::zero() || draining) {
+    return;
+  }
+
+  // A large file is purged by Filer in rounds of at most
+  // filer_max_purge_ops objects: judge the latency of one round.
+  const uint64_t max_ops = std::max<uint64_t>(g_conf()->filer_max_purge_ops, 1);
+  uint64_t rounds = 1;
+  if (item.action != PurgeItem::PURGE_DIR && item.size > 0) {
+    uint64_t num = Striper::get_num_objects(item.layout, item.size);
+    rounds = std::max<uint64_t>((num + max_ops - 1) / max_ops, 1);
+  }
+  lat /= rounds;
+
+  // Adjust at most once per window worth of completed ops, so that one
+  // slow (or fast) purge does not move the window by itself
+  const uint32_t ops = _calculate_ops(item);
+  completions_since_adjust += ops;
+  if (completions_since_adjust < purge_ops_window) {
+    return;
+  }
+  completions_since_adjust = 0;
+  if (lat > target) {
+    purge_ops_window = std::max<uint64_t>(purge_ops_window / 2, 1);
+  } else if (purge_ops_window < max_purge_ops) {
+    purge_ops_window = std::min<uint64_t>(purge_ops_window + ops, max_purge_ops);
+  }
+  dout(10) << "purge latency " << lat << " target " << target
+           << ", op window now " << purge_ops_window << dendl;
+  logger->set(l_pq_executing_ops_limit, _op_limit());
+}
+
 void PurgeQueue::_go_readonly(int r)
 {
   if (readonly) return;
@@ -560,7 +612,8 @@ void PurgeQueue::_commit_ops(int r, const std::vector<PurgeItemCommitOp>& ops_ve
   ceph_assert(gather.has_subs());
 
   gather.set_finisher(new C_OnFinisher(
-	              new LambdaContext([this, expire_to](int r) {
+	              new LambdaContext([this, expire_to,
+                                         start=ceph::mono_clock::now()](int r) {
     std::lock_guard l(lock);
 
     if (r == -CEPHFS_EBLOCKLISTED) {
@@ -569,6 +622,10 @@ void PurgeQueue::_commit_ops(int r, const std::vector<PurgeItemCommitOp>& ops_ve
       return;
     }
 
+    auto iter = in_flight.find(expire_to);
+    if (iter != in_flight.end()) {
+      _update_op_window(iter->second, ceph::mono_clock::now() - start);
+    }
     _execute_item_complete(expire_to);
     _consume();
 
@@ -593,6 +650,10 @@ void PurgeQueue::_execute_item(
   ceph_assert(ceph_mutex_is_locked_by_me(lock));
 
   in_flight[expire_to] = item;
+  utime_t now = ceph_clock_now();
+  if (item.stamp != utime_t() && now > item.stamp) {
+    logger->tinc(l_pq_item_age, now - item.stamp);
+  }
   logger->set(l_pq_executing, in_flight.size());
   files_high_water = std::max<uint64_t>(files_high_water,
                               in_flight.size());
@@ -713,6 +774,9 @@ void PurgeQueue::_execute_item_complete(
   logger->set(l_pq_executing_ops_high_water, ops_high_water);
 
   dout(10) << "completed item for ino " << iter->second.ino << dendl;
+  if (iter->second.action == PurgeItem::PURGE_FILE) {
+    logger->inc(l_pq_executed_bytes, iter->second.size);
+  }
 
   in_flight.erase(iter);
   logger->set(l_pq_executing, in_flight.size());
@@ -769,6 +833,15 @@ void PurgeQueue::update_op_limit(const MDSMap &mds_map)
   if (cct->_conf->mds_max_purge_ops) {
     max_purge_ops = std::min(max_purge_ops, cct->_conf->mds_max_purge_ops);
   }
+
+  // Start the latency driven window at the full limit, and never let it
+  // exceed a lowered one
+  if (purge_ops_window == 0 || purge_ops_window > max_purge_ops) {
+    purge_ops_window = max_purge_ops;
+  }
+  if (logger) {
+    logger->set(l_pq_executing_ops_limit, _op_limit());
+  }
 }
 
 void PurgeQueue::handle_conf_change(const std::set<std::string>& changed, const MDSMap& mds_map)
@@ -91,6 +91,9 @@ enum {
   l_pq_executing_high_water,
   l_pq_executed,
   l_pq_item_in_journal,
+  l_pq_executed_bytes,
+  l_pq_item_age,
+  l_pq_executing_ops_limit,
   l_pq_last
 };
 
@@ -183,6 +186,8 @@ private:
   uint32_t _calculate_ops(const PurgeItem &item) const;
 
   bool _can_consume();
+  uint64_t _op_limit() const;
+  void _update_op_window(const PurgeItem &item, ceph::timespan lat);
 
   // recover the journal write_pos (drop any partial written entry)
   void _recover();
@@ -228,6 +233,12 @@ private:
   // Dynamic op limit per MDS based on PG count
   uint64_t max_purge_ops = 0;
 
+  // Ops allowed in flight when mds_purge_target_latency is set: grown
+  // additively while purges complete under the target latency and halved
+  // when they don't, never above max_purge_ops
+  uint64_t purge_ops_window = 0;
+  uint64_t completions_since_adjust = 0;
+
   // How many bytes were remaining when drain() was first called,
   // used for indicating progress.
   uint64_t drain_initial = 0;
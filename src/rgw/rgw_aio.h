@@ -93,6 +93,10 @@ class Aio {
   // wait for all outstanding completions and return their results
   virtual AioResultList drain() = 0;
 
+  // resize the window of outstanding cost. shrinking it does not affect
+  // operations that are already in flight
+  virtual void set_window(uint64_t window) {}
+
   static OpFunc librados_op(librados::ObjectReadOperation&& op,
                             optional_yield y);
   static OpFunc librados_op(librados::ObjectWriteOperation&& op,
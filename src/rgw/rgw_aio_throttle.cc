@@ -109,6 +109,15 @@ AioResultList BlockingAioThrottle::drain()
   return std::move(completed);
 }
 
+void BlockingAioThrottle::set_window(uint64_t w)
+{
+  std::scoped_lock lock{mutex};
+  window = w;
+  if (waiter_ready()) {
+    cond.notify_one();
+  }
+}
+
 template <typename CompletionToken>
 auto YieldingAioThrottle::async_wait(CompletionToken&& token)
 {
@@ -199,4 +208,10 @@ AioResultList YieldingAioThrottle::drain()
   }
   return std::move(completed);
 }
+
+void YieldingAioThrottle::set_window(uint64_t w)
+{
+  // called from within the coroutine strand, so it can't have a waiter
+  window = w;
+}
 } // namespace rgw
@@ -2,6 +2,7 @@
 // vim: ts=8 sw=2 smarttab ft=cpp
 
 #include "rgw_compression.h"
+#include "rgw_perf_counters.h"
 
 #define dout_subsys ceph_subsys_rgw
 
@@ -47,7 +48,13 @@ int RGWPutObj_Compress::process(bufferlist&& in, uint64_t logical_offset)
     if ((logical_offset > 0 && compressed) || // if previous part was compressed
         (logical_offset == 0)) {              // or it's the first part
       ldout(cct, 10) << "Compression for rgw is enabled, compress part " << in.length() << dendl;
+      const auto start = ceph::mono_clock::now();
+      const auto in_len = in.length();
       int cr = compressor->compress(in, out, compressor_message);
+      if (perfcounter) {
+        perfcounter->inc(l_rgw_compress_b, in_len);
+        perfcounter->tinc(l_rgw_compress_lat, ceph::mono_clock::now() - start);
+      }
       if (cr < 0) {
         if (logical_offset > 0) {
           lderr(cct) << "Compression failed with exit code " << cr
@@ -135,7 +142,12 @@ int RGWGetObj_Decompress::handle_data(bufferlist& bl, off_t bl_ofs, off_t bl_len
       iter_in_bl.seek(ofs_in_bl);
     }
     iter_in_bl.copy(first_block->len, tmp);
+    const auto start = ceph::mono_clock::now();
     int cr = compressor->decompress(tmp, out_bl, cs_info->compressor_message);
+    if (perfcounter) {
+      perfcounter->inc(l_rgw_decompress_b, first_block->len);
+      perfcounter->tinc(l_rgw_decompress_lat, ceph::mono_clock::now() - start);
+    }
     if (cr < 0) {
       lderr(cct) << "Decompression failed with exit code " << cr << dendl;
       return cr;
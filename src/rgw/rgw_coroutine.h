@@ -373,6 +373,10 @@ do {                            \
   drain_status.init(); \
   yield_until_true(drain_children(1, stack, cb))
 
+#define drain_all_but_stack_window_cb(stack, n, cb) \
+  drain_status.init(); \
+  yield_until_true(drain_children((n) + 1, stack, cb))
+
 #define drain_with_cb(n, cb) \
   drain_status.init(); \
   yield_until_true(drain_children(n, cb)); \
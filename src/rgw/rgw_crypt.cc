@@ -16,6 +16,7 @@
 #include "crypto/crypto_accel.h"
 #include "crypto/crypto_plugin.h"
 #include "rgw/rgw_kms.h"
+#include "rgw/rgw_perf_counters.h"
 #include "rapidjson/document.h"
 #include "rapidjson/writer.h"
 #include "rapidjson/error/error.h"
@@ -372,6 +373,78 @@ bool evp_sym_transform(CephContext* const cct,
   return (written + finally_written) == static_cast<int>(size);
 }
 
+/**
+ * Same as evp_sym_transform(), but keeps the cipher context and its expanded
+ * key schedule around, so that transforming a stream of chunks only costs an
+ * IV reset per chunk instead of a context allocation and key setup.
+ */
+template <std::size_t KeySizeV, std::size_t IvSizeV>
+class evp_sym_transformer {
+  using pctx_t = \
+    std::unique_ptr<EVP_CIPHER_CTX, decltype(&::EVP_CIPHER_CTX_free)>;
+
+  CephContext* const cct;
+  pctx_t pctx{ nullptr, EVP_CIPHER_CTX_free };
+
+public:
+  explicit evp_sym_transformer(CephContext* const cct) : cct(cct) {}
+
+  bool init(const EVP_CIPHER* const type,
+            const unsigned char* const key,
+            const bool encrypt)
+  {
+    pctx.reset(EVP_CIPHER_CTX_new());
+    if (!pctx) {
+      return false;
+    }
+    if (1 != EVP_CipherInit_ex(pctx.get(), type, nullptr,
+                               nullptr, nullptr, encrypt)) {
+      ldout(cct, 5) << "EVP: failed to 1st initialization stage" << dendl;
+      return false;
+    }
+    if constexpr (static_cast<bool>(IvSizeV)) {
+      ceph_assert(EVP_CIPHER_CTX_iv_length(pctx.get()) == IvSizeV);
+      ceph_assert(EVP_CIPHER_CTX_block_size(pctx.get()) == IvSizeV);
+    }
+    ceph_assert(EVP_CIPHER_CTX_key_length(pctx.get()) == KeySizeV);
+    if (1 != EVP_CipherInit_ex(pctx.get(), nullptr, nullptr, key, nullptr,
+                               encrypt)) {
+      ldout(cct, 5) << "EVP: failed to 2nd initialization stage" << dendl;
+      return false;
+    }
+    if (1 != EVP_CIPHER_CTX_set_padding(pctx.get(), 0)) {
+      ldout(cct, 5) << "EVP: cannot disable PKCS padding" << dendl;
+      return false;
+    }
+    return true;
+  }
+
+  bool transform(unsigned char* const out,
+                 const unsigned char* const in,
+                 const size_t size,
+                 const unsigned char* const iv)
+  {
+    // keep cipher, key and direction, only reset the IV
+    if (1 != EVP_CipherInit_ex(pctx.get(), nullptr, nullptr, nullptr, iv, -1)) {
+      ldout(cct, 5) << "EVP: failed to set IV" << dendl;
+      return false;
+    }
+    int written = 0;
+    ceph_assert(size <= static_cast<size_t>(std::numeric_limits<int>::max()));
+    if (1 != EVP_CipherUpdate(pctx.get(), out, &written, in, size)) {
+      ldout(cct, 5) << "EVP: EVP_CipherUpdate failed" << dendl;
+      return false;
+    }
+    int finally_written = 0;
+    if (1 != EVP_CipherFinal_ex(pctx.get(), out + written, &finally_written)) {
+      ldout(cct, 5) << "EVP: EVP_CipherFinal_ex failed" << dendl;
+      return false;
+    }
+    ceph_assert(finally_written == 0);
+    return (written + finally_written) == static_cast<int>(size);
+  }
+};
+
 
 /**
  * Encryption in CBC mode. Chunked to 4K blocks. Offset is used as IV for each 4K block.
@@ -435,8 +508,11 @@ public:
       cct, EVP_aes_256_cbc(), out, in, size, iv, key, encrypt);
   }
 
+  /* transforms size bytes read from in, which is advanced past them. chunks
+   * that are contiguous in the input bufferlist are transformed in place,
+   * only chunks straddling two buffers are gathered into a bounce buffer */
   bool cbc_transform(unsigned char* out,
-                     const unsigned char* in,
+                     bufferlist::const_iterator& in,
                      size_t size,
                      off_t stream_offset,
                      const unsigned char (&key)[AES_256_KEYSIZE],
@@ -450,23 +526,35 @@ public:
       if (!crypto_accel)
         failed_to_get_crypto = true;
     }
+    evp_sym_transformer<AES_256_KEYSIZE, AES_256_IVSIZE> evp(cct);
+    if (crypto_accel == nullptr &&
+        !evp.init(EVP_aes_256_cbc(), key, encrypt)) {
+      return false;
+    }
     bool result = true;
     unsigned char iv[AES_256_IVSIZE];
+    unsigned char bounce[CHUNK_SIZE];
     for (size_t offset = 0; result && (offset < size); offset += CHUNK_SIZE) {
       size_t process_size = offset + CHUNK_SIZE <= size ? CHUNK_SIZE : size - offset;
+      const char* p = nullptr;
+      size_t got = in.get_ptr_and_advance(process_size, &p);
+      const unsigned char* chunk = reinterpret_cast<const unsigned char*>(p);
+      if (got < process_size) {
+        memcpy(bounce, p, got);
+        in.copy(process_size - got, reinterpret_cast<char*>(bounce) + got);
+        chunk = bounce;
+      }
       prepare_iv(iv, stream_offset + offset);
       if (crypto_accel != nullptr) {
         if (encrypt) {
-          result = crypto_accel->cbc_encrypt(out + offset, in + offset,
+          result = crypto_accel->cbc_encrypt(out + offset, chunk,
                                              process_size, iv, key);
         } else {
-          result = crypto_accel->cbc_decrypt(out + offset, in + offset,
+          result = crypto_accel->cbc_decrypt(out + offset, chunk,
                                              process_size, iv, key);
         }
       } else {
-        result = cbc_transform(
-            out + offset, in + offset, process_size,
-            iv, key, encrypt);
+        result = evp.transform(out + offset, chunk, process_size, iv);
       }
     }
     return result;
@@ -485,11 +573,11 @@ public:
     output.clear();
     buffer::ptr buf(aligned_size + AES_256_IVSIZE);
     unsigned char* buf_raw = reinterpret_cast<unsigned char*>(buf.c_str());
-    const unsigned char* input_raw = reinterpret_cast<const unsigned char*>(input.c_str());
+    auto input_iter = input.cbegin(in_ofs);
 
     /* encrypt main bulk of data */
     result = cbc_transform(buf_raw,
-                           input_raw + in_ofs,
+                           input_iter,
                            aligned_size,
                            stream_offset, key, true);
     if (result && (unaligned_rest_size > 0)) {
@@ -512,8 +600,10 @@ public:
                                iv, key, true);
       }
       if (result) {
+        unsigned char rest[AES_256_IVSIZE];
+        input_iter.copy(unaligned_rest_size, reinterpret_cast<char*>(rest));
         for(size_t i = aligned_size; i < size; i++) {
-          *(buf_raw + i) ^= *(input_raw + in_ofs + i);
+          *(buf_raw + i) ^= rest[i - aligned_size];
         }
       }
     }
@@ -540,11 +630,11 @@ public:
     output.clear();
     buffer::ptr buf(aligned_size + AES_256_IVSIZE);
     unsigned char* buf_raw = reinterpret_cast<unsigned char*>(buf.c_str());
-    unsigned char* input_raw = reinterpret_cast<unsigned char*>(input.c_str());
+    auto input_iter = input.cbegin(in_ofs);
 
     /* decrypt main bulk of data */
     result = cbc_transform(buf_raw,
-                           input_raw + in_ofs,
+                           input_iter,
                            aligned_size,
                            stream_offset, key, false);
     if (result && unaligned_rest_size > 0) {
@@ -552,8 +642,11 @@ public:
       if (aligned_size % CHUNK_SIZE > 0) {
         /*use last chunk for unaligned part*/
         unsigned char iv[AES_256_IVSIZE] = {0};
+        unsigned char last[AES_256_IVSIZE];
+        input.cbegin(in_ofs + aligned_size - AES_256_IVSIZE).copy(
+          AES_256_IVSIZE, reinterpret_cast<char*>(last));
         result = cbc_transform(buf_raw + aligned_size,
-                               input_raw + in_ofs + aligned_size - AES_256_IVSIZE,
+                               last,
                                AES_256_IVSIZE,
                                iv, key, true);
       } else {
@@ -567,8 +660,10 @@ public:
                                iv, key, true);
       }
       if (result) {
+        unsigned char rest[AES_256_IVSIZE];
+        input_iter.copy(unaligned_rest_size, reinterpret_cast<char*>(rest));
         for(size_t i = aligned_size; i < size; i++) {
-          *(buf_raw + i) ^= *(input_raw + in_ofs + i);
+          *(buf_raw + i) ^= rest[i - aligned_size];
         }
       }
     }
@@ -720,9 +815,14 @@ int RGWGetObj_BlockDecrypt::fixup_range(off_t& bl_ofs, off_t& bl_end) {
 int RGWGetObj_BlockDecrypt::process(bufferlist& in, size_t part_ofs, size_t size)
 {
   bufferlist data;
+  const auto start = ceph::mono_clock::now();
   if (!crypt->decrypt(in, 0, size, data, part_ofs)) {
     return -ERR_INTERNAL_ERROR;
   }
+  if (perfcounter) {
+    perfcounter->inc(l_rgw_decrypt_b, size);
+    perfcounter->tinc(l_rgw_decrypt_lat, ceph::mono_clock::now() - start);
+  }
   off_t send_size = size - enc_begin_skip;
   if (ofs + enc_begin_skip + send_size > end + 1) {
     send_size = end + 1 - ofs - enc_begin_skip;
@@ -818,9 +918,14 @@ int RGWPutObj_BlockEncrypt::process(bufferlist&& data, uint64_t logical_offset)
   if (proc_size > 0) {
     bufferlist in, out;
     cache.splice(0, proc_size, &in);
+    const auto start = ceph::mono_clock::now();
     if (!crypt->encrypt(in, 0, proc_size, out, logical_offset)) {
       return -ERR_INTERNAL_ERROR;
     }
+    if (perfcounter) {
+      perfcounter->inc(l_rgw_encrypt_b, proc_size);
+      perfcounter->tinc(l_rgw_encrypt_lat, ceph::mono_clock::now() - start);
+    }
     int r = Pipe::process(std::move(out), logical_offset);
     logical_offset += proc_size;
     if (r < 0)
@@ -50,6 +50,20 @@ static string datalog_sync_full_sync_index_prefix = "data.full-sync.index";
 static string bucket_status_oid_prefix = "bucket.sync-status";
 static string object_status_oid_prefix = "bucket.sync-status";
 
+// count a log entry handed to sync, along with how far behind the source it is
+static void count_sync_entry(PerfCounters *counters, int entries_idx,
+                             int lag_idx, ceph::real_time timestamp)
+{
+  if (!counters) {
+    return;
+  }
+  counters->inc(entries_idx);
+  const auto now = ceph::real_clock::now();
+  if (timestamp != ceph::real_time{} && now > timestamp) {
+    counters->tinc(lag_idx, now - timestamp);
+  }
+}
+
 
 void rgw_datalog_info::decode_json(JSONObj *obj) {
   JSONDecoder::decode_json("num_objects", num_shards, obj);
@@ -1232,6 +1246,8 @@ class RGWRunBucketSourcesSyncCR : public RGWCoroutine {
   int cur_shard{0};
   bool again = false;
 
+  const int64_t spawn_window;
+
 public:
   RGWRunBucketSourcesSyncCR(RGWDataSyncCtx *_sc,
                             boost::intrusive_ptr<const RGWContinuousLeaseCR> lease_cr,
@@ -1389,7 +1405,6 @@ public:
   }
 };
 
-#define BUCKET_SHARD_SYNC_SPAWN_WINDOW 20
 #define DATA_SYNC_MAX_ERR_ENTRIES 10
 
 class RGWDataSyncShardCR : public RGWCoroutine {
@@ -1427,7 +1442,7 @@ class RGWDataSyncShardCR : public RGWCoroutine {
   set<string>::iterator modified_iter;
 
   uint64_t total_entries = 0;
-  static constexpr int spawn_window = BUCKET_SHARD_SYNC_SPAWN_WINDOW;
+  int spawn_window;
   bool *reset_backoff = nullptr;
 
   boost::intrusive_ptr<RGWContinuousLeaseCR> lease_cr;
@@ -1475,6 +1490,7 @@ public:
                      RGWSyncTraceNodeRef& _tn, bool *_reset_backoff)
     : RGWCoroutine(_sc->cct), sc(_sc), sync_env(_sc->env),
       pool(_pool), shard_id(_shard_id), sync_marker(_marker),
+      spawn_window(cct->_conf.get_val<int64_t>("rgw_data_sync_spawn_window")),
       status_oid(RGWDataSyncStatusManager::shard_obj_name(sc->source_zone, shard_id)),
       error_repo(pool, status_oid + ".retry"), tn(_tn),
       bucket_shard_cache(rgw::bucket_sync::Cache::create(target_cache_size))
@@ -1595,12 +1611,12 @@ public:
           }
           sync_marker.marker = iter->first;
 
-          drain_all_but_stack_cb(lease_stack.get(),
-                                 [&](uint64_t stack_id, int ret) {
-                                   if (ret < 0) {
-                                     tn->log(10, "a sync operation returned error");
-                                   }
-                                 });
+          drain_all_but_stack_window_cb(lease_stack.get(), spawn_window,
+                                        [&](uint64_t stack_id, int ret) {
+                                          if (ret < 0) {
+                                            tn->log(10, "a sync operation returned error");
+                                          }
+                                        });
         }
       } while (omapvals->more);
       omapvals.reset();
@@ -1741,14 +1757,16 @@ public:
           } else {
             spawn(sync_single_entry(source_bs, log_iter->entry.key, log_iter->log_id,
                                     log_iter->log_timestamp, false), false);
+            count_sync_entry(sync_env->counters, sync_counters::l_datalog_entries,
+                             sync_counters::l_datalog_lag, log_iter->log_timestamp);
           }
 
-          drain_all_but_stack_cb(lease_stack.get(),
-                                 [&](uint64_t stack_id, int ret) {
-                                   if (ret < 0) {
-                                     tn->log(10, "a sync operation returned error");
-                                   }
-                                 });
+          drain_all_but_stack_window_cb(lease_stack.get(), spawn_window,
+                                        [&](uint64_t stack_id, int ret) {
+                                          if (ret < 0) {
+                                            tn->log(10, "a sync operation returned error");
+                                          }
+                                        });
         }
 
         tn->log(20, SSTR("shard_id=" << shard_id << " sync_marker=" << sync_marker.marker
@@ -3662,8 +3680,6 @@ done:
   }
 };
 
-#define BUCKET_SYNC_SPAWN_WINDOW 20
-
 class RGWBucketShardFullSyncCR : public RGWCoroutine {
   RGWDataSyncCtx *sc;
   RGWDataSyncEnv *sync_env;
@@ -3687,6 +3703,8 @@ class RGWBucketShardFullSyncCR : public RGWCoroutine {
   RGWSyncTraceNodeRef tn;
   RGWBucketFullSyncShardMarkerTrack marker_tracker;
 
+  const int64_t spawn_window;
+
   struct _prefix_handler {
     RGWBucketSyncFlowManager::pipe_rules_ref rules;
     RGWBucketSyncFlowManager::pipe_rules::prefix_map_t::const_iterator iter;
@@ -3745,7 +3763,8 @@ public:
       status_oid(status_oid),
       tn(sync_env->sync_tracer->add_node(tn_parent, "full_sync",
                                          SSTR(bucket_shard_str{bs}))),
-      marker_tracker(sc, status_oid, sync_info.full_marker, tn, objv_tracker)
+      marker_tracker(sc, status_oid, sync_info.full_marker, tn, objv_tracker),
+      spawn_window(cct->_conf.get_val<int64_t>("rgw_bucket_sync_spawn_window"))
   {
     zones_trace.insert(sc->source_zone.id, sync_pipe.info.dest_bs.bucket.get_key());
     prefix_handler.set_rules(sync_pipe.get_rules());
@@ -3811,7 +3830,7 @@ int RGWBucketShardFullSyncCR::operate(const DoutPrefixProvider *dpp)
                                  entry->key, &marker_tracker, zones_trace, tn),
                       false);
         }
-        drain_with_cb(BUCKET_SYNC_SPAWN_WINDOW,
+        drain_with_cb(spawn_window,
                       [&](uint64_t stack_id, int ret) {
                 if (ret < 0) {
                   tn->log(10, "a sync operation returned error");
@@ -3890,6 +3909,8 @@ class RGWBucketShardIncrementalSyncCR : public RGWCoroutine {
   RGWSyncTraceNodeRef tn;
   RGWBucketIncSyncShardMarkerTrack marker_tracker;
 
+  const int64_t spawn_window;
+
 public:
   RGWBucketShardIncrementalSyncCR(RGWDataSyncCtx *_sc,
                                   rgw_bucket_sync_pipe& _sync_pipe,
@@ -3906,7 +3927,8 @@ public:
       tn(sync_env->sync_tracer->add_node(_tn_parent, "inc_sync",
                                          SSTR(bucket_shard_str{bs}))),
       marker_tracker(sc, status_oid, sync_info.inc_marker, tn,
-                     objv_tracker, stable_timestamp)
+                     objv_tracker, stable_timestamp),
+      spawn_window(cct->_conf.get_val<int64_t>("rgw_bucket_sync_spawn_window"))
   {
     set_description() << "bucket shard incremental sync bucket="
         << bucket_shard_str{bs};
@@ -4106,9 +4128,11 @@ int RGWBucketShardIncrementalSyncCR::operate(const DoutPrefixProvider *dpp)
                              entry->timestamp, owner, entry->op, entry->state,
                              cur_id, &marker_tracker, entry->zones_trace, tn),
                   false);
+            count_sync_entry(sync_env->counters, sync_counters::l_bilog_entries,
+                             sync_counters::l_bilog_lag, entry->timestamp);
           }
         // }
-        drain_with_cb(BUCKET_SYNC_SPAWN_WINDOW,
+        drain_with_cb(spawn_window,
                       [&](uint64_t stack_id, int ret) {
                 if (ret < 0) {
                   tn->log(10, "a sync operation returned error");
@@ -4301,7 +4325,8 @@ RGWRunBucketSourcesSyncCR::RGWRunBucketSourcesSyncCR(RGWDataSyncCtx *_sc,
     lease_cr(std::move(lease_cr)), target_bs(_target_bs), source_bs(_source_bs),
     tn(sync_env->sync_tracer->add_node(_tn_parent, "bucket_sync_sources",
                                        SSTR( "target=" << target_bucket.value_or(rgw_bucket()) << ":source_bucket=" << source_bucket.value_or(rgw_bucket()) << ":source_zone=" << sc->source_zone))),
-    progress(progress)
+    progress(progress),
+    spawn_window(cct->_conf.get_val<int64_t>("rgw_bucket_sync_spawn_window"))
 {
   if (target_bs) {
     target_bucket = target_bs->bucket;
@@ -4371,7 +4396,7 @@ int RGWRunBucketSourcesSyncCR::operate(const DoutPrefixProvider *dpp)
 
         yield_spawn_window(new RGWRunBucketSyncCoroutine(sc, lease_cr, sync_pair, tn,
                                                          cur_progress),
-                           BUCKET_SYNC_SPAWN_WINDOW,
+                           spawn_window,
                            [&](uint64_t stack_id, int ret) {
                              handle_complete_stack(stack_id);
                              if (ret < 0) {
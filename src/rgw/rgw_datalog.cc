@@ -1,6 +1,7 @@
 // -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
 // vim: ts=8 sw=2 smarttab ft=cpp
 
+#include <algorithm>
 #include <vector>
 
 #include "common/debug.h"
@@ -17,6 +18,7 @@
 #include "cls_fifo_legacy.h"
 #include "rgw_datalog.h"
 #include "rgw_log_backing.h"
+#include "rgw_perf_counters.h"
 #include "rgw_tools.h"
 
 #define dout_context g_ceph_context
@@ -385,7 +387,9 @@ RGWDataChangesLog::RGWDataChangesLog(CephContext* cct)
   : cct(cct),
     num_shards(cct->_conf->rgw_data_log_num_shards),
     prefix(get_prefix()),
-    changes(cct->_conf->rgw_data_log_changes_size) {}
+    changes(cct->_conf->rgw_data_log_changes_size),
+    batch_max_entries(cct->_conf.get_val<uint64_t>(
+			"rgw_data_log_batch_max_entries")) {}
 
 bs::error_code DataLogBackends::handle_init(entries_t e) noexcept {
   std::unique_lock l(m);
@@ -482,6 +486,10 @@ int RGWDataChangesLog::start(const DoutPrefixProvider *dpp, const RGWZone* _zone
   bes = std::move(*besr);
   renew_thread = make_named_thread("rgw_dt_lg_renew",
 				   &RGWDataChangesLog::renew_run, this);
+  if (batch_max_entries > 0) {
+    batch_thread = make_named_thread("rgw_dt_lg_flush",
+				     &RGWDataChangesLog::batch_run, this);
+  }
   return 0;
 }
 
@@ -656,6 +664,33 @@ int RGWDataChangesLog::add_entry(const DoutPrefixProvider *dpp, const RGWBucketI
   status->cond = new RefCountedCond;
   status->pending = true;
 
+  if (batch_thread.joinable()) {
+    /* let the flusher write this along with everything else queued while
+     * its previous write was in flight, and wait for it like any other
+     * waiter would. once going down the flusher may already have exited,
+     * so write the entry directly below instead */
+    std::unique_lock ql{batch_lock};
+    if (!going_down()) {
+      status->cur_sent = now;
+      cond = status->cond;
+      cond->get();
+      sl.unlock();
+
+      const bool wake = batch.empty();
+      batch[index].emplace_back(bs, status);
+      ql.unlock();
+      if (wake) {
+	batch_cond.notify_one();
+      }
+
+      ldpp_dout(dpp, 20) << "RGWDataChangesLog::add_entry() queued update with now="
+			 << now << dendl;
+      int ret = cond->wait();
+      cond->put();
+      return ret;
+    }
+  }
+
   ceph::real_time expiration;
 
   int ret;
@@ -938,6 +973,13 @@ RGWDataChangesLog::~RGWDataChangesLog() {
     renew_stop();
     renew_thread.join();
   }
+  if (batch_thread.joinable()) {
+    {
+      std::scoped_lock l{batch_lock};
+      batch_cond.notify_all();
+    }
+    batch_thread.join();
+  }
 }
 
 void RGWDataChangesLog::renew_run() noexcept {
@@ -985,6 +1027,86 @@ void RGWDataChangesLog::renew_stop()
   renew_cond.notify_all();
 }
 
+void RGWDataChangesLog::complete_change(ChangeStatus& status, int ret)
+{
+  std::unique_lock sl(status.lock);
+  RefCountedCond* cond = status.cond;
+  status.pending = false;
+  /* time of when the entry was queued, not written */
+  status.cur_expiration = status.cur_sent;
+  status.cur_expiration += make_timespan(cct->_conf->rgw_data_log_window);
+  status.cond = nullptr;
+  sl.unlock();
+
+  cond->done(ret);
+  cond->put();
+}
+
+int RGWDataChangesLog::flush_batch(const DoutPrefixProvider *dpp)
+{
+  decltype(batch) pending;
+  {
+    std::scoped_lock l{batch_lock};
+    pending.swap(batch);
+  }
+
+  int r = 0;
+  auto be = bes->head();
+  for (auto& [index, changed] : pending) {
+    for (auto first = changed.begin(); first != changed.end(); ) {
+      auto last = first + std::min<uint64_t>(changed.end() - first,
+					     batch_max_entries);
+      RGWDataChangesBE::entries entries;
+      for (auto i = first; i != last; ++i) {
+	const auto& [bs, status] = *i;
+	rgw_data_change change;
+	bufferlist bl;
+	change.entity_type = ENTITY_TYPE_BUCKET;
+	change.key = bs.get_key();
+	change.timestamp = status->cur_sent;
+	encode(change, bl);
+	be->prepare(change.timestamp, change.key, std::move(bl), entries);
+      }
+
+      auto ret = be->push(dpp, index, std::move(entries));
+      if (ret < 0) {
+	ldpp_dout(dpp, -1) << "ERROR: failed to push " << (last - first)
+			   << " entries to data log shard " << index
+			   << ": " << cpp_strerror(-ret) << dendl;
+	r = ret;
+      }
+      if (perfcounter) {
+	perfcounter->inc(l_rgw_datalog_batch, last - first);
+      }
+      for (; first != last; ++first) {
+	complete_change(*first->second, ret);
+      }
+    }
+  }
+  return r;
+}
+
+void RGWDataChangesLog::batch_run() noexcept
+{
+  const DoutPrefix dp(cct, dout_subsys, "rgw data changes log: ");
+  std::unique_lock l{batch_lock};
+  for (;;) {
+    batch_cond.wait(l, [this] { return going_down() || !batch.empty(); });
+    if (batch.empty()) {
+      break; // going down with nothing left to write
+    }
+    /* write whatever is queued right away; entries that arrive while this
+     * write is in flight are picked up together by the next pass */
+    l.unlock();
+    int r = flush_batch(&dp);
+    if (r < 0) {
+      ldpp_dout(&dp, 0) << "ERROR: RGWDataChangesLog::flush_batch returned error r="
+			<< r << dendl;
+    }
+    l.lock();
+  }
+}
+
 void RGWDataChangesLog::mark_modified(int shard_id, const rgw_bucket_shard& bs)
 {
   auto key = bs.get_key();
@@ -214,6 +214,17 @@ class RGWDataChangesLog {
   void renew_stop();
   std::thread renew_thread;
 
+  // entries waiting for the flusher, grouped by data log shard
+  const uint64_t batch_max_entries;
+  ceph::mutex batch_lock = ceph::make_mutex("RGWDataChangesLog::batch_lock");
+  ceph::condition_variable batch_cond;
+  bc::flat_map<int, std::vector<std::pair<rgw_bucket_shard,
+					  ChangeStatusPtr>>> batch;
+  void batch_run() noexcept;
+  int flush_batch(const DoutPrefixProvider *dpp);
+  void complete_change(ChangeStatus& status, int ret);
+  std::thread batch_thread;
+
   std::function<bool(const rgw_bucket& bucket, optional_yield y, const DoutPrefixProvider *dpp)> bucket_filter;
   int choose_oid(const rgw_bucket_shard& bs);
   bool going_down() const;
@@ -17,6 +17,7 @@
 
 #include <list> // XXX
 #include <sstream>
+#include <thread>
 #include "xxhash.h"
 
 #define dout_context g_ceph_context
@@ -299,6 +300,7 @@ class RGWGCIOManager {
     string oid;
     int index{-1};
     string tag;
+    ceph::mono_time start;
   };
 
   deque<IO> ios;
@@ -311,24 +313,68 @@ class RGWGCIOManager {
 #define MAX_AIO_DEFAULT 10
   size_t max_aio{MAX_AIO_DEFAULT};
 
+  /* the current number of tail ios allowed in flight. It stays at max_aio
+   * unless rgw_gc_io_target_latency is set, in which case it is adjusted
+   * (additive increase, multiplicative decrease) against the observed
+   * completion latency
+   */
+  size_t aio_window{MAX_AIO_DEFAULT};
+  ceph::timespan target_lat{ceph::timespan::zero()};
+  size_t completions_since_adjust{0};
+
+  void update_window(ceph::timespan lat) {
+    if (target_lat == ceph::timespan::zero()) {
+      return;
+    }
+    /* adjust at most once per window worth of completions, so that a
+     * single slow (or fast) op does not move the window by itself */
+    if (++completions_since_adjust < aio_window) {
+      return;
+    }
+    completions_since_adjust = 0;
+    const size_t old_window = aio_window;
+    if (lat > target_lat) {
+      aio_window = std::max<size_t>(aio_window / 2, 1);
+    } else if (aio_window < max_aio) {
+      ++aio_window;
+    }
+    ldpp_dout(dpp, 20) << "RGWGCIOManager: io latency=" << lat <<
+      ", aio window=" << aio_window << dendl;
+    /* the gauge is the sum of the windows of all io managers */
+    if (perfcounter && aio_window > old_window) {
+      perfcounter->inc(l_rgw_gc_io_window, aio_window - old_window);
+    } else if (perfcounter && aio_window < old_window) {
+      perfcounter->dec(l_rgw_gc_io_window, old_window - aio_window);
+    }
+  }
+
 public:
   RGWGCIOManager(const DoutPrefixProvider* _dpp, CephContext *_cct, RGWGC *_gc) : dpp(_dpp),
                                                                                   cct(_cct),
                                                                                   gc(_gc) {
     max_aio = cct->_conf->rgw_gc_max_concurrent_io;
+    aio_window = max_aio;
+    target_lat = cct->_conf.get_val<std::chrono::milliseconds>("rgw_gc_io_target_latency");
     remove_tags.resize(min(static_cast<int>(cct->_conf->rgw_gc_max_objs), rgw_shards_max()));
     tag_io_size.resize(min(static_cast<int>(cct->_conf->rgw_gc_max_objs), rgw_shards_max()));
+    if (perfcounter) {
+      perfcounter->inc(l_rgw_gc_io_window, aio_window);
+    }
   }
 
   ~RGWGCIOManager() {
     for (auto io : ios) {
       io.c->release();
     }
+    if (perfcounter) {
+      perfcounter->dec(l_rgw_gc_io_inflight, ios.size());
+      perfcounter->dec(l_rgw_gc_io_window, aio_window);
+    }
   }
 
   int schedule_io(IoCtx *ioctx, const string& oid, ObjectWriteOperation *op,
 		  int index, const string& tag) {
-    while (ios.size() > max_aio) {
+    while (ios.size() > aio_window) {
       if (gc->going_down()) {
         return 0;
       }
@@ -342,9 +388,13 @@ public:
     auto c = librados::Rados::aio_create_completion(nullptr, nullptr);
     int ret = ioctx->aio_operate(oid, c, op);
     if (ret < 0) {
+      c->release();
       return ret;
     }
-    ios.push_back(IO{IO::TailIO, c, oid, index, tag});
+    ios.push_back(IO{IO::TailIO, c, oid, index, tag, ceph::mono_clock::now()});
+    if (perfcounter) {
+      perfcounter->inc(l_rgw_gc_io_inflight);
+    }
 
     return 0;
   }
@@ -356,6 +406,19 @@ public:
     int ret = io.c->get_return_value();
     io.c->release();
 
+    if (io.type == IO::TailIO) {
+      auto lat = ceph::mono_clock::now() - io.start;
+      update_window(lat);
+      if (perfcounter) {
+        perfcounter->tinc(l_rgw_gc_io_lat, lat);
+        perfcounter->inc(ret < 0 && ret != -ENOENT ?
+                         l_rgw_gc_remove_obj_failed : l_rgw_gc_remove_obj);
+      }
+    }
+    if (perfcounter) {
+      perfcounter->dec(l_rgw_gc_io_inflight);
+    }
+
     if (ret == -ENOENT) {
       ret = 0;
     }
@@ -464,6 +527,7 @@ public:
     if (perfcounter) {
       /* log the count of tags retired for rate estimation */
       perfcounter->inc(l_rgw_gc_retire, rt.size());
+      perfcounter->inc(l_rgw_gc_io_inflight);
     }
     ios.push_back(index_io);
   }
@@ -526,7 +590,10 @@ int RGWGC::process(int index, int max_secs, bool expired_only,
   string marker;
   string next_marker;
   bool truncated;
-  IoCtx *ctx = new IoCtx;
+  /* tail objects of a gc shard typically live in a handful of pools, keep
+   * one ioctx per pool rather than recreating it whenever the pool changes
+   * between consecutive chain entries */
+  std::map<string, IoCtx> ioctxs;
   do {
     int max = 100;
     std::list<cls_rgw_gc_obj_info> entries;
@@ -576,7 +643,6 @@ int RGWGC::process(int index, int max_secs, bool expired_only,
 
     marker = next_marker;
 
-    string last_pool;
     std::list<cls_rgw_gc_obj_info>::iterator iter;
     for (iter = entries.begin(); iter != entries.end(); ++iter) {
       cls_rgw_gc_obj_info& info = *iter;
@@ -603,21 +669,21 @@ int RGWGC::process(int index, int max_secs, bool expired_only,
 	for (liter = chain.objs.begin(); liter != chain.objs.end(); ++liter) {
 	  cls_rgw_obj& obj = *liter;
 
-	  if (obj.pool != last_pool) {
-	    delete ctx;
-	    ctx = new IoCtx;
-	    ret = rgw_init_ioctx(this, store->get_rados_handle(), obj.pool, *ctx);
+	  auto ctx_iter = ioctxs.find(obj.pool);
+	  if (ctx_iter == ioctxs.end()) {
+	    IoCtx new_ctx;
+	    ret = rgw_init_ioctx(this, store->get_rados_handle(), obj.pool, new_ctx);
 	    if (ret < 0) {
         if (transitioned_objects_cache[index]) {
           goto done;
         }
-	      last_pool = "";
 	      ldpp_dout(this, 0) << "ERROR: failed to create ioctx pool=" <<
 		obj.pool << dendl;
 	      continue;
 	    }
-	    last_pool = obj.pool;
+	    ctx_iter = ioctxs.emplace(obj.pool, std::move(new_ctx)).first;
 	  }
+	  IoCtx *ctx = &ctx_iter->second;
 
 	  ctx->locator_set_key(obj.loc);
 
@@ -666,7 +732,6 @@ done:
    * hold the system if backend is unresponsive
    */
   l.unlock(&store->gc_pool_ctx, obj_names[index]);
-  delete ctx;
 
   return 0;
 }
@@ -677,19 +742,55 @@ int RGWGC::process(bool expired_only)
 
   const int start = ceph::util::generate_random_number(0, max_objs - 1);
 
-  RGWGCIOManager io_manager(this, store->ctx(), this);
+  const int max_shards = std::min<int>(
+    cct->_conf.get_val<uint64_t>("rgw_gc_max_concurrent_shards"), max_objs);
 
-  for (int i = 0; i < max_objs; i++) {
-    int index = (i + start) % max_objs;
-    int ret = process(index, max_secs, expired_only, io_manager);
-    if (ret < 0)
-      return ret;
-  }
-  if (!going_down()) {
-    io_manager.drain();
+  /* shards are handed out in order to up to max_shards workers, each with
+   * its own io manager (and thus its own window of in-flight ios) */
+  std::atomic<int> next_shard = { 0 };
+  std::atomic<int> error = { 0 };
+
+  auto process_shards = [&] {
+    RGWGCIOManager io_manager(this, store->ctx(), this);
+
+    for (int i = next_shard++; i < max_objs; i = next_shard++) {
+      if (error != 0 || going_down()) {
+        break;
+      }
+      int index = (i + start) % max_objs;
+      if (perfcounter) {
+        perfcounter->inc(l_rgw_gc_shards_active);
+      }
+      int ret = process(index, max_secs, expired_only, io_manager);
+      if (perfcounter) {
+        perfcounter->dec(l_rgw_gc_shards_active);
+      }
+      if (ret < 0) {
+        error = ret;
+        return;
+      }
+    }
+    if (!going_down()) {
+      io_manager.drain();
+    }
+  };
+
+  if (max_shards <= 1) {
+    process_shards();
+  } else {
+    ldpp_dout(this, 10) << "RGWGC::process processing up to " << max_shards <<
+      " gc shards concurrently" << dendl;
+    std::vector<std::thread> workers;
+    workers.reserve(max_shards);
+    for (int i = 0; i < max_shards; i++) {
+      workers.push_back(make_named_thread("rgw_gc_shard", process_shards));
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
   }
 
-  return 0;
+  return error;
 }
 
 bool RGWGC::going_down()
@@ -50,7 +50,9 @@ public:
     stop_processor();
     finalize();
   }
-  vector<bool> transitioned_objects_cache;
+  /* one byte per gc shard rather than a packed vector<bool>, since shards
+   * may be processed concurrently (see rgw_gc_max_concurrent_shards) */
+  vector<char> transitioned_objects_cache;
   int send_chain(cls_rgw_obj_chain& chain, const string& tag);
 
   // asynchronously defer garbage collection on an object that's still being read
@@ -7,6 +7,9 @@
 #include <algorithm>
 #include <tuple>
 #include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
 
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string.hpp>
@@ -438,6 +441,11 @@ public:
     list_params.prefix = prefix;
   }
 
+  /* restrict the listing to a single bucket index shard */
+  void set_shard_id(int shard_id) {
+    list_params.shard_id = shard_id;
+  }
+
   int init(const DoutPrefixProvider *dpp) {
     return fetch(dpp);
   }
@@ -770,7 +778,8 @@ class RGWLC::WorkPool
 {
   using TVector = ceph::containers::tiny_vector<WorkQ, 3>;
   TVector wqs;
-  uint64_t ix;
+  /* atomic, since several index shard listers may enqueue concurrently */
+  std::atomic<uint64_t> ix;
 
 public:
   WorkPool(RGWLC::LCWorker* wk, uint16_t n_threads, uint32_t qmax)
@@ -795,8 +804,7 @@ public:
   }
 
   void enqueue(WorkItem item) {
-    const auto tix = ix;
-    ix = (ix+1) % wqs.size();
+    const auto tix = ix++ % wqs.size();
     (wqs[tix]).enqueue(std::move(item));
   }
 
@@ -1505,6 +1513,56 @@ int RGWLC::bucket_lc_process(string& shard_id, LCWorker* worker,
 		      << prefix_map.size()
 		      << dendl;
 
+  /* a sharded bucket may be listed one index shard at a time, with up to
+   * rgw_lc_max_concurrent_index_shards listers feeding the workpool */
+  const int num_index_shards =
+    bucket->get_info().layout.current_index.layout.normal.num_shards;
+  const int max_listers = std::min<int>(
+    cct->_conf.get_val<uint64_t>("rgw_lc_max_concurrent_index_shards"),
+    num_index_shards);
+  std::atomic<uint64_t> scanned = { 0 };
+  const auto process_start = ceph::mono_clock::now();
+
+  /* queued work items refer to the lister that produced them, so the
+   * listers are kept until the workpool has been drained */
+  std::mutex obj_listers_lock;
+  std::list<LCObjsLister> obj_listers;
+  auto drain_workpool = [&] {
+    worker->workpool->drain();
+    obj_listers.clear();
+  };
+
+  auto list_and_enqueue = [&](lc_op& op, const string& prefix,
+			      int shard_id) -> int {
+    LCObjsLister* lister;
+    {
+      std::lock_guard l{obj_listers_lock};
+      lister = &obj_listers.emplace_back(store, bucket.get());
+    }
+    auto& ol = *lister;
+    ol.set_prefix(prefix);
+    if (shard_id != RGW_NO_SHARD) {
+      ol.set_shard_id(shard_id);
+    }
+
+    int ret = ol.init(this);
+    if (ret < 0) {
+      return ret;
+    }
+
+    op_env oenv(op, store, worker, bucket.get(), ol);
+    LCOpRule orule(oenv);
+    orule.build(); // why can't ctor do it?
+    rgw_bucket_dir_entry* o{nullptr};
+    for (; ol.get_obj(this, &o /* , fetch_barrier */); ol.next()) {
+      orule.update();
+      std::tuple<LCOpRule, rgw_bucket_dir_entry> t1 = {orule, *o};
+      worker->workpool->enqueue(WorkItem{t1});
+      ++scanned;
+    }
+    return 0;
+  };
+
   rgw_obj_key pre_marker;
   rgw_obj_key next_marker;
   for(auto prefix_iter = prefix_map.begin(); prefix_iter != prefix_map.end();
@@ -1531,27 +1589,59 @@ int RGWLC::bucket_lc_process(string& shard_id, LCWorker* worker,
       pre_marker = next_marker;
     }
 
-    LCObjsLister ol(store, bucket.get());
-    ol.set_prefix(prefix_iter->first);
-
-    ret = ol.init(this);
-    if (ret < 0) {
-      if (ret == (-ENOENT))
-        return 0;
-      ldpp_dout(this, 0) << "ERROR: store->list_objects():" <<dendl;
-      return ret;
+    if (max_listers <= 1) {
+      ret = list_and_enqueue(op, prefix_iter->first, RGW_NO_SHARD);
+      if (ret < 0) {
+	if (ret == (-ENOENT))
+	  return 0;
+	ldpp_dout(this, 0) << "ERROR: store->list_objects():" <<dendl;
+	return ret;
+      }
+    } else {
+      /* versions of an object share an index shard, so each shard can be
+       * listed (and its rules evaluated) independently of the others */
+      std::atomic<int> next_shard = { 0 };
+      std::atomic<int> error = { 0 };
+      std::vector<std::thread> listers;
+      listers.reserve(max_listers);
+      for (int i = 0; i < max_listers; ++i) {
+	listers.push_back(make_named_thread("lc_shard_list", [&] {
+	  for (int shard = next_shard++; shard < num_index_shards;
+	       shard = next_shard++) {
+	    if (going_down() || worker_should_stop(stop_at, once)) {
+	      break;
+	    }
+	    int r = list_and_enqueue(op, prefix_iter->first, shard);
+	    if (r < 0 && r != -ENOENT) {
+	      ldpp_dout(this, 0) << "ERROR: store->list_objects(): shard="
+				 << shard << " ret=" << r << dendl;
+	      error = r;
+	      break;
+	    }
+	  }
+	}));
+      }
+      for (auto& l : listers) {
+	l.join();
+      }
+      if (error < 0) {
+	drain_workpool();
+	return error;
+      }
     }
+    drain_workpool();
+  }
 
-    op_env oenv(op, store, worker, bucket.get(), ol);
-    LCOpRule orule(oenv);
-    orule.build(); // why can't ctor do it?
-    rgw_bucket_dir_entry* o{nullptr};
-    for (; ol.get_obj(this, &o /* , fetch_barrier */); ol.next()) {
-      orule.update();
-      std::tuple<LCOpRule, rgw_bucket_dir_entry> t1 = {orule, *o};
-      worker->workpool->enqueue(WorkItem{t1});
-    }
-    worker->workpool->drain();
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+    ceph::mono_clock::now() - process_start);
+  ldpp_dout(this, 5) << __func__ << "(): bucket=" << bucket_name
+		     << " scanned=" << scanned << " in " << elapsed.count()
+		     << "ms ("
+		     << (scanned * 1000 / std::max<int64_t>(elapsed.count(), 1))
+		     << " objs/s) index shard listers=" << std::max(max_listers, 1)
+		     << dendl;
+  if (perfcounter) {
+    perfcounter->inc(l_rgw_lc_scanned, scanned);
   }
 
   ret = handle_multipart_expiration(bucket.get(), prefix_map, worker, stop_at, once);
@@ -14,6 +14,7 @@
 #include "rgw_perf_counters.h"
 #include "common/dout.h"
 #include <chrono>
+#include <unordered_map>
 
 #define dout_subsys ceph_subsys_rgw
 
@@ -68,6 +69,7 @@ class Manager : public DoutPrefixProvider {
   std::vector<std::thread> workers;
   const uint32_t stale_reservations_period_s;
   const uint32_t reservations_cleanup_period_s;
+  const uint32_t max_inflight_per_queue;
  
   const std::string Q_LIST_OBJECT_NAME = "queues_list_object";
 
@@ -121,6 +123,7 @@ class Manager : public DoutPrefixProvider {
   class tokens_waiter {
     const std::chrono::hours infinite_duration;
     size_t pending_tokens;
+    size_t max_pending_tokens;
     Timer timer;
  
     struct token {
@@ -131,7 +134,7 @@ class Manager : public DoutPrefixProvider {
       
       ~token() {
         --waiter.pending_tokens;
-        if (waiter.pending_tokens == 0) {
+        if (waiter.pending_tokens <= waiter.max_pending_tokens) {
           waiter.timer.cancel();
         }   
       }   
@@ -142,12 +145,15 @@ class Manager : public DoutPrefixProvider {
     tokens_waiter(boost::asio::io_context& io_context) :
       infinite_duration(1000),
       pending_tokens(0),
+      max_pending_tokens(0),
       timer(io_context) {}  
  
-    void async_wait(spawn::yield_context yield) { 
-      if (pending_tokens == 0) {
+    // wait until no more than max_pending tokens are outstanding
+    void async_wait(spawn::yield_context yield, size_t max_pending = 0) { 
+      if (pending_tokens <= max_pending) {
         return;
       }
+      max_pending_tokens = max_pending;
       timer.expires_from_now(infinite_duration);
       boost::system::error_code ec; 
       timer.async_wait(yield[ec]);
@@ -159,9 +165,13 @@ class Manager : public DoutPrefixProvider {
     }   
   };
 
+  // push endpoints used while processing a batch of entries, keyed by
+  // endpoint, endpoint args and topic
+  using endpoints_t = std::unordered_map<std::string, RGWPubSubEndpoint::Ptr>;
+
   // processing of a specific entry
   // return whether processing was successfull (true) or not (false)
-  bool process_entry(const cls_queue_entry& entry, spawn::yield_context yield) {
+  bool process_entry(const cls_queue_entry& entry, endpoints_t& endpoints, spawn::yield_context yield) {
     event_entry_t event_entry;
     auto iter = entry.data.cbegin();
     try {
@@ -171,26 +181,38 @@ class Manager : public DoutPrefixProvider {
       return false;
     }
     try {
-      // TODO move endpoint creation to queue level
-      const auto push_endpoint = RGWPubSubEndpoint::create(event_entry.push_endpoint, event_entry.arn_topic,
-          RGWHTTPArgs(event_entry.push_endpoint_args, this), 
-          cct);
-      ldpp_dout(this, 20) << "INFO: push endpoint created: " << event_entry.push_endpoint <<
-        " for entry: " << entry.marker << dendl;
+      // entries of a queue almost always share their endpoint, so create it
+      // once per batch rather than once per entry. all entries of a batch
+      // run on the strand of the queue, so the map needs no locking
+      auto& push_endpoint = endpoints[event_entry.push_endpoint + '\n' +
+        event_entry.push_endpoint_args + '\n' + event_entry.arn_topic];
+      if (!push_endpoint) {
+        push_endpoint = RGWPubSubEndpoint::create(event_entry.push_endpoint, event_entry.arn_topic,
+            RGWHTTPArgs(event_entry.push_endpoint_args, this), 
+            cct);
+        ldpp_dout(this, 20) << "INFO: push endpoint created: " << event_entry.push_endpoint <<
+          " for entry: " << entry.marker << dendl;
+      }
+      const auto start_time = ceph::mono_clock::now();
       const auto ret = push_endpoint->send_to_completion_async(cct, event_entry.event, optional_yield(io_context, yield));
       if (ret < 0) {
         ldpp_dout(this, 5) << "WARNING: push entry: " << entry.marker << " to endpoint: " << event_entry.push_endpoint 
           << " failed. error: " << ret << " (will retry)" << dendl;
+        if (perfcounter) perfcounter->inc(l_rgw_pubsub_push_retry);
         return false;
       } else {
         ldpp_dout(this, 20) << "INFO: push entry: " << entry.marker << " to endpoint: " << event_entry.push_endpoint 
           << " ok" <<  dendl;
-        if (perfcounter) perfcounter->inc(l_rgw_pubsub_push_ok);
+        if (perfcounter) {
+          perfcounter->inc(l_rgw_pubsub_push_ok);
+          perfcounter->tinc(l_rgw_pubsub_push_lat, ceph::mono_clock::now() - start_time);
+        }
         return true;
       }
     } catch (const RGWPubSubEndpoint::configuration_error& e) {
       ldpp_dout(this, 5) << "WARNING: failed to create push endpoint: " 
           << event_entry.push_endpoint << " for entry: " << entry.marker << ". error: " << e.what() << " (will retry) " << dendl;
+      if (perfcounter) perfcounter->inc(l_rgw_pubsub_push_retry);
       return false;
     }
   }
@@ -305,15 +327,17 @@ class Manager : public DoutPrefixProvider {
       auto remove_entries = false;
       auto entry_idx = 1U;
       tokens_waiter waiter(io_context);
+      endpoints_t endpoints;
       for (auto& entry : entries) {
+        // keep a bounded number of pushes in flight against the endpoint
+        waiter.async_wait(yield, max_inflight_per_queue - 1);
         if (has_error) {
           // bail out on first error
           break;
         }
-        // TODO pass entry pointer instead of by-value
-        spawn::spawn(yield, [this, &queue_name, entry_idx, total_entries, &end_marker, &remove_entries, &has_error, &waiter, entry](spawn::yield_context yield) {
+        spawn::spawn(yield, [this, &queue_name, entry_idx, total_entries, &end_marker, &remove_entries, &has_error, &waiter, &endpoints, &entry](spawn::yield_context yield) {
             const auto token = waiter.make_token();
-            if (process_entry(entry, yield)) {
+            if (process_entry(entry, endpoints, yield)) {
               ldpp_dout(this, 20) << "INFO: processing of entry: " << 
                 entry.marker << " (" << entry_idx << "/" << total_entries << ") from: " << queue_name << " ok" << dendl;
               remove_entries = true;
@@ -474,7 +498,7 @@ public:
   Manager(CephContext* _cct, uint32_t _max_queue_size, uint32_t _queues_update_period_ms, 
           uint32_t _queues_update_retry_ms, uint32_t _queue_idle_sleep_us, u_int32_t failover_time_ms, 
           uint32_t _stale_reservations_period_s, uint32_t _reservations_cleanup_period_s,
-          uint32_t _worker_count, rgw::sal::RadosStore* store) :
+          uint32_t _max_inflight_per_queue, uint32_t _worker_count, rgw::sal::RadosStore* store) :
     max_queue_size(_max_queue_size),
     queues_update_period_ms(_queues_update_period_ms),
     queues_update_retry_ms(_queues_update_retry_ms),
@@ -486,7 +510,8 @@ public:
     work_guard(boost::asio::make_work_guard(io_context)),
     worker_count(_worker_count),
     stale_reservations_period_s(_stale_reservations_period_s),
-    reservations_cleanup_period_s(_reservations_cleanup_period_s)
+    reservations_cleanup_period_s(_reservations_cleanup_period_s),
+    max_inflight_per_queue(_max_inflight_per_queue)
     {
       spawn::spawn(io_context, [this](spawn::yield_context yield) {
             process_queues(yield);
@@ -582,6 +607,7 @@ constexpr uint32_t FAILOVER_TIME_MSEC = 3*Q_LIST_UPDATE_MSEC; // FAILOVER TIME 3
 constexpr uint32_t WORKER_COUNT = 1;                 // 1 worker thread
 constexpr uint32_t STALE_RESERVATIONS_PERIOD_S = 120;   // cleanup reservations that are more than 2 minutes old
 constexpr uint32_t RESERVATIONS_CLEANUP_PERIOD_S = 30; // reservation cleanup every 30 seconds
+constexpr uint32_t MAX_INFLIGHT_PER_QUEUE = 128;     // concurrent pushes per persistent queue
 
 bool init(CephContext* cct, rgw::sal::RadosStore* store, const DoutPrefixProvider *dpp) {
   if (s_manager) {
@@ -592,7 +618,7 @@ bool init(CephContext* cct, rgw::sal::RadosStore* store, const DoutPrefixProvide
       Q_LIST_UPDATE_MSEC, Q_LIST_RETRY_MSEC, 
       IDLE_TIMEOUT_USEC, FAILOVER_TIME_MSEC, 
       STALE_RESERVATIONS_PERIOD_S, RESERVATIONS_CLEANUP_PERIOD_S,
-      WORKER_COUNT,
+      MAX_INFLIGHT_PER_QUEUE, WORKER_COUNT,
       store);
   return true;
 }
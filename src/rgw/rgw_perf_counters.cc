@@ -21,6 +21,8 @@ int rgw_perf_start(CephContext *cct)
   plb.add_u64_counter(l_rgw_get, "get", "Gets");
   plb.add_u64_counter(l_rgw_get_b, "get_b", "Size of gets");
   plb.add_time_avg(l_rgw_get_lat, "get_initial_lat", "Get latency");
+  plb.add_u64_avg(l_rgw_get_obj_window, "get_obj_window", "Get object read window size");
+  plb.add_u64(l_rgw_get_obj_inflight, "get_obj_inflight", "Get object bytes read in flight");
   plb.add_u64_counter(l_rgw_put, "put", "Puts");
   plb.add_u64_counter(l_rgw_put_b, "put_b", "Size of puts");
   plb.add_time_avg(l_rgw_put_lat, "put_initial_lat", "Put latency");
@@ -31,10 +33,25 @@ int rgw_perf_start(CephContext *cct)
   plb.add_u64_counter(l_rgw_cache_hit, "cache_hit", "Cache hits");
   plb.add_u64_counter(l_rgw_cache_miss, "cache_miss", "Cache miss");
 
+  plb.add_u64_counter(l_rgw_compress_b, "compress_b", "Size of compressed input");
+  plb.add_time_avg(l_rgw_compress_lat, "compress_lat", "Compression latency");
+  plb.add_u64_counter(l_rgw_decompress_b, "decompress_b", "Size of decompressed input");
+  plb.add_time_avg(l_rgw_decompress_lat, "decompress_lat", "Decompression latency");
+  plb.add_u64_counter(l_rgw_encrypt_b, "encrypt_b", "Size of encrypted input");
+  plb.add_time_avg(l_rgw_encrypt_lat, "encrypt_lat", "Encryption latency");
+  plb.add_u64_counter(l_rgw_decrypt_b, "decrypt_b", "Size of decrypted input");
+  plb.add_time_avg(l_rgw_decrypt_lat, "decrypt_lat", "Decryption latency");
+
   plb.add_u64_counter(l_rgw_keystone_token_cache_hit, "keystone_token_cache_hit", "Keystone token cache hits");
   plb.add_u64_counter(l_rgw_keystone_token_cache_miss, "keystone_token_cache_miss", "Keystone token cache miss");
 
   plb.add_u64_counter(l_rgw_gc_retire, "gc_retire_object", "GC object retires");
+  plb.add_u64_counter(l_rgw_gc_remove_obj, "gc_remove_object", "GC tail object removals");
+  plb.add_u64_counter(l_rgw_gc_remove_obj_failed, "gc_remove_object_failed", "GC tail object removal failures");
+  plb.add_time_avg(l_rgw_gc_io_lat, "gc_io_lat", "GC RADOS IO latency");
+  plb.add_u64(l_rgw_gc_io_inflight, "gc_io_inflight", "GC RADOS IOs in flight");
+  plb.add_u64(l_rgw_gc_io_window, "gc_io_window", "GC RADOS IO concurrency window, summed over GC shard workers");
+  plb.add_u64(l_rgw_gc_shards_active, "gc_shards_active", "GC shards being processed");
 
   plb.add_u64_counter(l_rgw_lc_expire_current, "lc_expire_current",
 		      "Lifecycle current expiration");
@@ -49,6 +66,11 @@ int rgw_perf_start(CephContext *cct)
 		      "Lifecycle non-current transition");
   plb.add_u64_counter(l_rgw_lc_abort_mpu, "lc_abort_mpu",
 		      "Lifecycle abort multipart upload");
+  plb.add_u64_counter(l_rgw_lc_scanned, "lc_scanned",
+		      "Lifecycle objects scanned");
+
+  plb.add_u64_avg(l_rgw_datalog_batch, "datalog_batch",
+		  "Data log entries per batched write");
 
   plb.add_u64_counter(l_rgw_pubsub_event_triggered, "pubsub_event_triggered", "Pubsub events with at least one topic");
   plb.add_u64_counter(l_rgw_pubsub_event_lost, "pubsub_event_lost", "Pubsub events lost");
@@ -58,6 +80,8 @@ int rgw_perf_start(CephContext *cct)
   plb.add_u64_counter(l_rgw_pubsub_push_ok, "pubsub_push_ok", "Pubsub events pushed to an endpoint");
   plb.add_u64_counter(l_rgw_pubsub_push_failed, "pubsub_push_failed", "Pubsub events failed to be pushed to an endpoint");
   plb.add_u64(l_rgw_pubsub_push_pending, "pubsub_push_pending", "Pubsub events pending reply from endpoint");
+  plb.add_time_avg(l_rgw_pubsub_push_lat, "pubsub_push_lat", "Pubsub latency of pushing a queued event to an endpoint");
+  plb.add_u64_counter(l_rgw_pubsub_push_retry, "pubsub_push_retry", "Pubsub queued events left in the queue for retry");
   plb.add_u64_counter(l_rgw_pubsub_missing_conf, "pubsub_missing_conf", "Pubsub events could not be handled because of missing configuration");
   
   perfcounter = plb.create_perf_counters();
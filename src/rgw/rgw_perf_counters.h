@@ -18,6 +18,9 @@ enum {
   l_rgw_get_b,
   l_rgw_get_lat,
 
+  l_rgw_get_obj_window,
+  l_rgw_get_obj_inflight,
+
   l_rgw_put,
   l_rgw_put_b,
   l_rgw_put_lat,
@@ -28,10 +31,25 @@ enum {
   l_rgw_cache_hit,
   l_rgw_cache_miss,
 
+  l_rgw_compress_b,
+  l_rgw_compress_lat,
+  l_rgw_decompress_b,
+  l_rgw_decompress_lat,
+  l_rgw_encrypt_b,
+  l_rgw_encrypt_lat,
+  l_rgw_decrypt_b,
+  l_rgw_decrypt_lat,
+
   l_rgw_keystone_token_cache_hit,
   l_rgw_keystone_token_cache_miss,
 
   l_rgw_gc_retire,
+  l_rgw_gc_remove_obj,
+  l_rgw_gc_remove_obj_failed,
+  l_rgw_gc_io_lat,
+  l_rgw_gc_io_inflight,
+  l_rgw_gc_io_window,
+  l_rgw_gc_shards_active,
 
   l_rgw_lc_expire_current,
   l_rgw_lc_expire_noncurrent,
@@ -39,6 +57,9 @@ enum {
   l_rgw_lc_transition_current,
   l_rgw_lc_transition_noncurrent,
   l_rgw_lc_abort_mpu,
+  l_rgw_lc_scanned,
+
+  l_rgw_datalog_batch,
 
   l_rgw_pubsub_event_triggered,
   l_rgw_pubsub_event_lost,
@@ -48,6 +69,8 @@ enum {
   l_rgw_pubsub_push_ok,
   l_rgw_pubsub_push_failed,
   l_rgw_pubsub_push_pending,
+  l_rgw_pubsub_push_lat,
+  l_rgw_pubsub_push_retry,
   l_rgw_pubsub_missing_conf,
 
   l_rgw_last,
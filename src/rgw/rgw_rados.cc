@@ -66,6 +66,7 @@ using namespace librados;
 #include "rgw_lc.h"
 
 #include "rgw_object_expirer_core.h"
+#include "rgw_perf_counters.h"
 #include "rgw_sync.h"
 #include "rgw_sync_counters.h"
 #include "rgw_sync_trace.h"
@@ -6371,10 +6372,14 @@ int get_obj_data::flush(rgw::AioResultList&& results) {
 
     bl_list.push_back(bl);
     offset += bl.length();
+    put_inflight(bl.length());
+    const auto start = ceph::mono_clock::now();
     int r = client_cb->handle_data(bl, 0, bl.length());
     if (r < 0) {
       return r;
     }
+    client_wait += ceph::mono_clock::now() - start;
+    update_window(bl.length());
 
     if (rgwrados->get_use_datacache()) {
       const std::lock_guard l(d3n_get_data.d3n_lock);
@@ -6391,6 +6396,61 @@ int get_obj_data::flush(rgw::AioResultList&& results) {
   return 0;
 }
 
+void get_obj_data::init_window(uint64_t initial, uint64_t max)
+{
+  window = min_window = initial;
+  max_window = std::max(initial, max);
+  if (perfcounter) {
+    perfcounter->inc(l_rgw_get_obj_window, window);
+  }
+}
+
+void get_obj_data::update_window(uint64_t len)
+{
+  if (max_window <= min_window) {
+    return; // adaptive window disabled
+  }
+  bytes_since_adjust += len;
+  if (bytes_since_adjust < window) {
+    return;
+  }
+  // a full window was handed to the client. like tcp slow start, double
+  // the window while the request spends its time waiting on rados, and
+  // halve it if the client can't drain the data as fast as we read it
+  if (client_wait > rados_wait) {
+    window = std::max(window / 2, min_window);
+  } else {
+    window = std::min(window * 2, max_window);
+  }
+  bytes_since_adjust = 0;
+  rados_wait = client_wait = ceph::timespan::zero();
+  aio->set_window(window);
+  if (perfcounter) {
+    perfcounter->inc(l_rgw_get_obj_window, window);
+  }
+}
+
+void get_obj_data::get_inflight(uint64_t len)
+{
+  bytes_submitted += len;
+  if (perfcounter) {
+    perfcounter->inc(l_rgw_get_obj_inflight, len);
+  }
+}
+
+void get_obj_data::put_inflight(uint64_t len)
+{
+  // short reads may complete fewer bytes than were accounted on submit
+  len = std::min(len, bytes_submitted - bytes_completed);
+  if (len == 0) {
+    return;
+  }
+  bytes_completed += len;
+  if (perfcounter) {
+    perfcounter->dec(l_rgw_get_obj_inflight, len);
+  }
+}
+
 static int _get_obj_iterate_cb(const DoutPrefixProvider *dpp,
                                const rgw_raw_obj& read_obj, off_t obj_ofs,
                                off_t read_ofs, off_t len, bool is_head_obj,
@@ -6446,7 +6506,10 @@ int RGWRados::get_obj_iterate_cb(const DoutPrefixProvider *dpp,
   const uint64_t cost = len;
   const uint64_t id = obj_ofs; // use logical object offset for sorting replies
 
+  d->get_inflight(cost);
+  const auto start = ceph::mono_clock::now();
   auto completed = d->aio->get(obj, rgw::Aio::librados_op(std::move(op), d->yield), cost, id);
+  d->rados_wait += ceph::mono_clock::now() - start;
 
   return d->flush(std::move(completed));
 }
@@ -6459,9 +6522,11 @@ int RGWRados::Object::Read::iterate(const DoutPrefixProvider *dpp, int64_t ofs,
   RGWObjectCtx& obj_ctx = source->get_ctx();
   const uint64_t chunk_size = cct->_conf->rgw_get_obj_max_req_size;
   const uint64_t window_size = cct->_conf->rgw_get_obj_window_size;
+  const uint64_t max_window_size = cct->_conf.get_val<Option::size_t>("rgw_get_obj_max_window_size");
 
   auto aio = rgw::make_throttle(window_size, y);
   get_obj_data data(store, cb, &*aio, ofs, y);
+  data.init_window(window_size, max_window_size);
 
   int r = store->iterate_obj(dpp, obj_ctx, source->get_bucket_info(), state.obj,
                              ofs, end, chunk_size, _get_obj_iterate_cb, &data, y);
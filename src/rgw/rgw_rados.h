@@ -1591,6 +1591,18 @@ struct get_obj_data {
   rgw::AioResultList completed; // completed read results, sorted by offset
   optional_yield yield;
 
+  // adaptive read window: grows from min_window towards max_window while
+  // the request mostly waits on rados, and shrinks back under client
+  // backpressure. see update_window()
+  uint64_t window = 0;
+  uint64_t min_window = 0;
+  uint64_t max_window = 0;
+  uint64_t bytes_since_adjust = 0;
+  ceph::timespan rados_wait = ceph::timespan::zero();
+  ceph::timespan client_wait = ceph::timespan::zero();
+  uint64_t bytes_submitted = 0;
+  uint64_t bytes_completed = 0;
+
   get_obj_data(RGWRados* rgwrados, RGWGetDataCB* cb, rgw::Aio* aio,
                uint64_t offset, optional_yield yield)
                : rgwrados(rgwrados), client_cb(cb), aio(aio), offset(offset), yield(yield) {}
@@ -1598,6 +1610,7 @@ struct get_obj_data {
     if (rgwrados->get_use_datacache()) {
       const std::lock_guard l(d3n_get_data.d3n_lock);
     }
+    put_inflight(bytes_submitted - bytes_completed);
   }
 
   D3nGetObjData d3n_get_data;
@@ -1605,20 +1618,32 @@ struct get_obj_data {
 
   int flush(rgw::AioResultList&& results);
 
+  void init_window(uint64_t initial, uint64_t max);
+  void update_window(uint64_t len);
+  void get_inflight(uint64_t len);
+  void put_inflight(uint64_t len);
+
   void cancel() {
     // wait for all completions to drain and ignore the results
     aio->drain();
   }
 
-  int drain() {
+  rgw::AioResultList wait() {
+    const auto start = ceph::mono_clock::now();
     auto c = aio->wait();
+    rados_wait += ceph::mono_clock::now() - start;
+    return c;
+  }
+
+  int drain() {
+    auto c = wait();
     while (!c.empty()) {
       int r = flush(std::move(c));
       if (r < 0) {
         cancel();
         return r;
       }
-      c = aio->wait();
+      c = wait();
     }
     return flush(std::move(c));
   }
@@ -6214,15 +6214,15 @@ int RGWSelectObj_ObjStore_S3::create_message(std::string &out_string, u_int32_t
   encode_int(&buff[i], header_len, i);
 
   crc32->reset();
-  *crc32 = std::for_each( buff, buff + 8, *crc32 );//crc for starting 8 bytes
-  preload_crc = (*crc32)();
+  crc32->process_bytes(buff, 8);//crc for starting 8 bytes
+  preload_crc = crc32->checksum();
   encode_int(&buff[i], preload_crc, i);
 
   i += result_len;//advance to the end of payload.
 
   crc32->reset();
-  *crc32 = std::for_each( buff, buff + i, *crc32 );//crc for payload + checksum
-  message_crc = (*crc32)();
+  crc32->process_bytes(buff, i);//crc for payload + checksum
+  message_crc = crc32->checksum();
   char out_encode[4];
   encode_int(out_encode, message_crc, i);
   out_string.append(out_encode,sizeof(out_encode));
@@ -6233,7 +6233,7 @@ int RGWSelectObj_ObjStore_S3::create_message(std::string &out_string, u_int32_t
 #define PAYLOAD_LINE "\n<Payload>\n<Records>\n<Payload>\n"
 #define END_PAYLOAD_LINE "\n</Payload></Records></Payload>"
 
-int RGWSelectObj_ObjStore_S3::run_s3select(const char* query, const char* input, size_t input_length)
+int RGWSelectObj_ObjStore_S3::run_s3select(const char* query, const bufferlist& input)
 {
   int status = 0;
   csv_object::csv_defintions csv;
@@ -6281,9 +6281,23 @@ int RGWSelectObj_ObjStore_S3::run_s3select(const char* query, const char* input,
     status = -1;
   }
   else {
-    status = m_s3_csv_object->run_s3select_on_stream(m_result, input, input_length, s->obj_size);
-    if(status<0) {
-      m_result.append(m_s3_csv_object->get_error_description());
+    //all segments of the chunk are streamed into the same response message,
+    //rather than paying for headers, CRC and a flush per segment
+    int i = 0;
+    for (const auto& it : input.buffers()) {
+      if (it.length() == 0) {
+        ldpp_dout(this, 10) << "s3select:it->_len is zero. segment " << i << " out of "
+                            << input.get_num_buffers() << " obj-size " << s->obj_size << dendl;
+        continue;
+      }
+      ldpp_dout(this, 20) << "processing segment " << i << " out of " << input.get_num_buffers()
+                          << " len " << it.length() << " obj-size " << s->obj_size << dendl;
+      status = m_s3_csv_object->run_s3select_on_stream(m_result, it.c_str(), it.length(), s->obj_size);
+      if(status<0) {
+        m_result.append(m_s3_csv_object->get_error_description());
+        break;
+      }
+      i++;
     }
   }
 
@@ -6367,34 +6381,16 @@ int RGWSelectObj_ObjStore_S3::send_response_data(bufferlist& bl, off_t ofs, off_
     dump_errno(s);
   }
 
-  auto bl_len = bl.get_num_buffers();
-
   // Explicitly use chunked transfer encoding so that we can stream the result
   // to the user without having to wait for the full length of it.
   if (chunk_number == 0) {
     end_header(s, this, "application/xml", CHUNKED_TRANSFER_ENCODING);
   }
 
-  int status=0;
-  int i=0;
-
-  for(auto& it : bl.buffers()) {
-
-    ldpp_dout(this, 10) << "processing segment " << i << " out of " << bl_len << " off " << ofs
-                      << " len " << len << " obj-size " << s->obj_size << dendl;
+  ldpp_dout(this, 10) << "processing chunk " << chunk_number << " segments " << bl.get_num_buffers()
+                      << " off " << ofs << " len " << len << " obj-size " << s->obj_size << dendl;
 
-    if(it.length() == 0) {
-      ldpp_dout(this, 10) << "s3select:it->_len is zero. segment " << i << " out of " << bl_len
-                        <<  " obj-size " << s->obj_size << dendl;
-      continue; 
-    }
-
-    status = run_s3select(m_sql_query.c_str(), &(it)[0], it.length());
-    if(status<0) {
-      break;
-    }
-    i++;
-  }
+  int status = run_s3select(m_sql_query.c_str(), bl);
 
   chunk_number++;
 
@@ -941,7 +941,7 @@ private:
 
   int create_message(std::string&, u_int32_t result_len, u_int32_t header_len);
 
-  int run_s3select(const char* query, const char* input, size_t input_length);
+  int run_s3select(const char* query, const bufferlist& input);
 
   int extract_by_tag(std::string tag_name, std::string& result);
 
@@ -20,6 +20,11 @@ PerfCountersRef build(CephContext *cct, const std::string& name)
   b.add_time_avg(l_poll, "poll_latency", "Average latency of replication log requests");
   b.add_u64_counter(l_poll_err, "poll_errors", "Number of replication log request errors");
 
+  b.add_u64_counter(l_datalog_entries, "datalog_entries", "Number of data log entries dispatched for sync");
+  b.add_time_avg(l_datalog_lag, "datalog_lag", "Average age of data log entries when dispatched for sync");
+  b.add_u64_counter(l_bilog_entries, "bilog_entries", "Number of bucket index log entries dispatched for sync");
+  b.add_time_avg(l_bilog_lag, "bilog_lag", "Average age of bucket index log entries when dispatched for sync");
+
   auto logger = PerfCountersRef{ b.create_perf_counters(), cct };
   cct->get_perfcounters_collection()->add(logger.get());
   return logger;
@@ -17,6 +17,11 @@ enum {
   l_poll,
   l_poll_err,
 
+  l_datalog_entries,
+  l_datalog_lag,
+  l_bilog_entries,
+  l_bilog_lag,
+
   l_last,
 };
 
@@ -3,6 +3,7 @@
 
 #include <sstream>
 #include <list>
+#include <thread>
 #include <gtest/gtest.h>
 
 #include "include/Context.h"
@@ -124,6 +125,50 @@ TEST_F(TestSimplePolicy, test_lookup_hit_and_promoted) {
   }
 }
 
+TEST_F(TestSimplePolicy, test_concurrent_lookup_hit) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([this] {
+      for (int i = 0; i < 100; i++) {
+        for (auto& cache_file_name : m_promoted_lru) {
+          ASSERT_EQ(OBJ_CACHE_PROMOTED,
+                    m_simple_policy->lookup_object(cache_file_name));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(m_promoted_lru.size(), m_simple_policy->get_promoted_entry_num());
+
+  // restore the LRU order expected on teardown
+  for (auto& cache_file_name : m_promoted_lru) {
+    m_simple_policy->lookup_object(cache_file_name);
+  }
+}
+
+TEST_F(TestSimplePolicy, test_concurrent_lookup_miss) {
+  std::atomic<uint64_t> promotions = 0;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([this, &promotions] {
+      for (int i = 0; i < 100; i++) {
+        if (m_simple_policy->lookup_object("concurrent_miss_file") ==
+              OBJ_CACHE_NONE) {
+          promotions++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(1U, promotions);
+  ASSERT_EQ(OBJ_CACHE_SKIP, m_simple_policy->get_status("concurrent_miss_file"));
+  ASSERT_EQ(1U, m_simple_policy->get_promoting_entry_num());
+}
+
 TEST_F(TestSimplePolicy, test_update_state_from_promoting_to_none) {
   ASSERT_TRUE(m_cache_size - m_promoted_lru.size() == m_simple_policy->get_free_size());
   insert_entry_into_promoting_lru("promoting_to_none_file_1");
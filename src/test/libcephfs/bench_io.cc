@@ -0,0 +1,125 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+/*
+ * Measures how data I/O scales with the number of threads sharing a
+ * single libcephfs mount: every thread writes and then reads back its
+ * own file through the same ceph_mount_info, so all of them contend on
+ * that client instance.
+ */
+
+#include "include/cephfs/libcephfs.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void usage(const char *name)
+{
+  std::cout << name << " <threads> <io-size> <ios-per-thread>\n"
+	    << "\t threads: number of threads sharing one mount.\n"
+	    << "\t io-size: bytes per write/read call.\n"
+	    << "\t ios-per-thread: calls each thread issues per phase.\n";
+}
+
+static int run_phase(struct ceph_mount_info *cmount, bool write,
+		     const std::vector<int>& fds, size_t io_size, size_t ios)
+{
+  std::vector<std::thread> threads;
+  std::vector<int> results(fds.size(), 0);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < fds.size(); t++) {
+    threads.emplace_back([&, t] {
+      std::string buf(io_size, write ? 'a' + t % 26 : '\0');
+      for (size_t i = 0; i < ios; i++) {
+	int r = write ?
+	  ceph_write(cmount, fds[t], buf.data(), io_size, i * io_size) :
+	  ceph_read(cmount, fds[t], buf.data(), io_size, i * io_size);
+	if (r < 0) {
+	  results[t] = r;
+	  return;
+	}
+      }
+    });
+  }
+  for (auto& th : threads)
+    th.join();
+  const std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  for (int r : results) {
+    if (r < 0) {
+      std::cerr << (write ? "write" : "read") << " failed: " << r << std::endl;
+      return r;
+    }
+  }
+  const double bytes = double(io_size) * ios * fds.size();
+  std::cout << (write ? "write" : "read")
+	    << " threads: " << fds.size()
+	    << " io-size: " << io_size
+	    << " elapsed: " << elapsed.count() << "s"
+	    << " rate: " << (bytes / elapsed.count()) / (1 << 20) << " MB/s"
+	    << " iops: " << (ios * fds.size()) / elapsed.count() << std::endl;
+  return 0;
+}
+
+int main(int argc, const char **argv)
+{
+  if (argc < 4) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  const size_t nthreads = std::strtoull(argv[1], nullptr, 10);
+  const size_t io_size = std::strtoull(argv[2], nullptr, 10);
+  const size_t ios = std::strtoull(argv[3], nullptr, 10);
+  if (nthreads == 0 || io_size == 0 || ios == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  struct ceph_mount_info *cmount;
+  if (ceph_create(&cmount, nullptr) != 0 ||
+      ceph_conf_read_file(cmount, nullptr) != 0 ||
+      ceph_conf_parse_env(cmount, nullptr) != 0 ||
+      ceph_mount(cmount, "/") != 0) {
+    std::cerr << "failed to mount" << std::endl;
+    return 1;
+  }
+
+  std::vector<int> fds;
+  for (size_t t = 0; t < nthreads; t++) {
+    std::string path = "bench_io." + std::to_string(getpid()) + "." +
+      std::to_string(t);
+    int fd = ceph_open(cmount, path.c_str(), O_CREAT|O_RDWR|O_TRUNC, 0644);
+    if (fd < 0) {
+      std::cerr << "failed to open " << path << ": " << fd << std::endl;
+      ceph_shutdown(cmount);
+      return 1;
+    }
+    fds.push_back(fd);
+  }
+
+  int r = run_phase(cmount, true, fds, io_size, ios);
+  if (r == 0) {
+    for (int fd : fds)
+      ceph_fsync(cmount, fd, 0);
+    r = run_phase(cmount, false, fds, io_size, ios);
+  }
+
+  for (size_t t = 0; t < fds.size(); t++) {
+    ceph_close(cmount, fds[t]);
+    std::string path = "bench_io." + std::to_string(getpid()) + "." +
+      std::to_string(t);
+    ceph_unlink(cmount, path.c_str());
+  }
+  ceph_shutdown(cmount);
+  return r == 0 ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+/*
+ * Measures directory listing speed with attributes (readdirplus) on a
+ * directory populated by another client: one mount creates the entries,
+ * a second one lists them with ceph_readdirplus_r() in a number of passes,
+ * so the listing client starts without caps on any of the entries.
+ */
+
+#include "include/cephfs/libcephfs.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+static void usage(const char *name)
+{
+  std::cout << name << " <entries> <passes>\n"
+	    << "\t entries: number of files created in the directory.\n"
+	    << "\t passes: number of times the directory is listed.\n";
+}
+
+static int do_mount(struct ceph_mount_info **cmount)
+{
+  if (ceph_create(cmount, nullptr) != 0 ||
+      ceph_conf_read_file(*cmount, nullptr) != 0 ||
+      ceph_conf_parse_env(*cmount, nullptr) != 0 ||
+      ceph_mount(*cmount, "/") != 0) {
+    std::cerr << "failed to mount" << std::endl;
+    return -1;
+  }
+  return 0;
+}
+
+static int list_dir(struct ceph_mount_info *cmount, const std::string& dir,
+		    size_t *count)
+{
+  struct ceph_dir_result *dirp;
+  int r = ceph_opendir(cmount, dir.c_str(), &dirp);
+  if (r < 0)
+    return r;
+
+  struct dirent de;
+  struct ceph_statx stx;
+  *count = 0;
+  while ((r = ceph_readdirplus_r(cmount, dirp, &de, &stx,
+				 CEPH_STATX_BASIC_STATS, 0, nullptr)) > 0) {
+    ++*count;
+  }
+  ceph_closedir(cmount, dirp);
+  return r;
+}
+
+int main(int argc, const char **argv)
+{
+  if (argc < 3) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  const size_t entries = std::strtoull(argv[1], nullptr, 10);
+  const size_t passes = std::strtoull(argv[2], nullptr, 10);
+  if (entries == 0 || passes == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  struct ceph_mount_info *writer, *reader;
+  if (do_mount(&writer) < 0)
+    return 1;
+
+  const std::string dir = "bench_readdir." + std::to_string(getpid());
+  int r = ceph_mkdir(writer, dir.c_str(), 0755);
+  if (r < 0) {
+    std::cerr << "failed to create " << dir << ": " << r << std::endl;
+    ceph_shutdown(writer);
+    return 1;
+  }
+  for (size_t i = 0; i < entries && r >= 0; i++) {
+    std::string path = dir + "/" + std::to_string(i);
+    r = ceph_open(writer, path.c_str(), O_CREAT|O_WRONLY, 0644);
+    if (r >= 0)
+      r = ceph_close(writer, r);
+  }
+  if (r < 0) {
+    std::cerr << "failed to populate " << dir << ": " << r << std::endl;
+  } else if (do_mount(&reader) < 0) {
+    r = -1;
+  } else {
+    for (size_t pass = 0; pass < passes; pass++) {
+      size_t count;
+      const auto start = std::chrono::steady_clock::now();
+      r = list_dir(reader, dir, &count);
+      const std::chrono::duration<double> elapsed =
+	std::chrono::steady_clock::now() - start;
+      if (r < 0) {
+	std::cerr << "readdir failed: " << r << std::endl;
+	break;
+      }
+      std::cout << "pass: " << pass
+		<< " entries: " << count
+		<< " elapsed: " << elapsed.count() << "s"
+		<< " rate: " << count / elapsed.count() << " entries/s"
+		<< std::endl;
+    }
+    ceph_shutdown(reader);
+  }
+
+  for (size_t i = 0; i < entries; i++) {
+    std::string path = dir + "/" + std::to_string(i);
+    ceph_unlink(writer, path.c_str());
+  }
+  ceph_rmdir(writer, dir.c_str());
+  ceph_shutdown(writer);
+  return r < 0 ? 1 : 0;
+}
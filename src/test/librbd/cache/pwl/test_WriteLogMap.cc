@@ -331,6 +331,58 @@ TEST_F(TestWriteLogMap, OverlapSplit) {
   ASSERT_EQ(8, found0.front().block_extent.block_end);
 }
 
+TEST_F(TestWriteLogMap, MapRefs) {
+  TestLogMap map(m_cct);
+
+  auto e0 = make_shared<TestLogEntry>(0, 8);
+  map.add_log_entry(e0);
+  ASSERT_EQ(1, e0->get_map_ref());
+
+  /* Splits e0 in two */
+  auto e1 = make_shared<TestLogEntry>(2, 2);
+  map.add_log_entry(e1);
+  ASSERT_EQ(2, e0->get_map_ref());
+  ASSERT_EQ(1, e1->get_map_ref());
+
+  /* Trims the tail of e0's first piece and all of e1 */
+  auto e2 = make_shared<TestLogEntry>(1, 3);
+  map.add_log_entry(e2);
+  ASSERT_EQ(2, e0->get_map_ref());
+  ASSERT_EQ(0, e1->get_map_ref());
+  ASSERT_EQ(1, e2->get_map_ref());
+
+  /* Expecting: 0:e0, 1..3:e2, 4..7:e0 */
+  TestLogMapEntries found0 = map.find_map_entries(BlockExtent(0, 100));
+  ASSERT_EQ(3, found0.size());
+  ASSERT_EQ(e0, found0.front().log_entry);
+  ASSERT_EQ(0, found0.front().block_extent.block_start);
+  ASSERT_EQ(1, found0.front().block_extent.block_end);
+  found0.pop_front();
+  ASSERT_EQ(e2, found0.front().log_entry);
+  ASSERT_EQ(1, found0.front().block_extent.block_start);
+  ASSERT_EQ(4, found0.front().block_extent.block_end);
+  found0.pop_front();
+  ASSERT_EQ(e0, found0.front().log_entry);
+  ASSERT_EQ(4, found0.front().block_extent.block_start);
+  ASSERT_EQ(8, found0.front().block_extent.block_end);
+
+  /* Removing e0 drops both of its pieces */
+  map.remove_log_entry(e0);
+  ASSERT_EQ(0, e0->get_map_ref());
+  found0 = map.find_map_entries(BlockExtent(0, 100));
+  ASSERT_EQ(1, found0.size());
+  ASSERT_EQ(e2, found0.front().log_entry);
+
+  /* Covers everything */
+  auto e3 = make_shared<TestLogEntry>(0, 8);
+  map.add_log_entry(e3);
+  ASSERT_EQ(0, e2->get_map_ref());
+  ASSERT_EQ(1, e3->get_map_ref());
+  found0 = map.find_map_entries(BlockExtent(0, 100));
+  ASSERT_EQ(1, found0.size());
+  ASSERT_EQ(e3, found0.front().log_entry);
+}
+
 } // namespace pwl
 } // namespace cache
 } // namespace librbd
@@ -7,9 +7,11 @@
 #include "test/librbd/test_support.h"
 #include "test/librbd/mock/MockImageCtx.h"
 #include "include/rbd/librbd.hpp"
+#include "librbd/api/Io.h"
 #include "librbd/cache/pwl/ImageCacheState.h"
 #include "librbd/cache/pwl/Types.h"
 #include "librbd/cache/ImageWriteback.h"
+#include "librbd/io/ReadResult.h"
 #include "librbd/plugin/Api.h"
 
 namespace librbd {
@@ -64,6 +66,33 @@ struct TestMockCacheReplicatedWriteLog : public TestMockFixture {
   typedef librbd::cache::ImageWriteback<librbd::MockImageCtx> MockImageWriteback;
   typedef librbd::plugin::Api<librbd::MockImageCtx> MockApi;
 
+  /* Exposes the writeback state the elision tests have to control */
+  struct TestReplicatedWriteLog : public MockReplicatedWriteLog {
+    using MockReplicatedWriteLog::MockReplicatedWriteLog;
+
+    RWLock &entry_reader_lock() {
+      return this->m_entry_reader_lock;
+    }
+    ceph::mutex &log_append_lock() {
+      return this->m_log_append_lock;
+    }
+    std::shared_ptr<GenericWriteLogEntry> mapped_entry(const Extent &extent) {
+      auto log_entries = this->m_blocks_to_log_entries.find_log_entries(
+        pwl::block_extent(extent));
+      return log_entries.empty() ? nullptr : log_entries.front();
+    }
+    bool can_retire(std::shared_ptr<GenericWriteLogEntry> log_entry) {
+      std::lock_guard locker(this->m_lock);
+      return log_entry->can_retire();
+    }
+    uint64_t perf_counter(int idx) {
+      return this->m_perfcounter->get(idx);
+    }
+    void writeback_dirty_entries() {
+      this->process_writeback_dirty_entries();
+    }
+  };
+
   MockImageCacheStateRWL *get_cache_state(
       MockImageCtx& mock_image_ctx, MockApi& mock_api) {
     MockImageCacheStateRWL *rwl_state = new MockImageCacheStateRWL(&mock_image_ctx, mock_api);
@@ -759,6 +788,191 @@ TEST_F(TestMockCacheReplicatedWriteLog, compare_and_write_compare_failed) {
   ASSERT_EQ(0, finish_ctx3.wait());
 }
 
+TEST_F(TestMockCacheReplicatedWriteLog, writeback_elide_overwritten) {
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  MockImageCtx mock_image_ctx(*ictx);
+  MockImageWriteback mock_image_writeback(mock_image_ctx);
+  MockApi mock_api;
+  TestReplicatedWriteLog rwl(
+      mock_image_ctx, get_cache_state(mock_image_ctx, mock_api),
+      mock_image_writeback, mock_api);
+  expect_op_work_queue(mock_image_ctx);
+  expect_metadata_set(mock_image_ctx);
+
+  MockContextRWL finish_ctx1;
+  expect_context_complete(finish_ctx1, 0);
+  rwl.init(&finish_ctx1);
+  ASSERT_EQ(0, finish_ctx1.wait());
+
+  int fadvise_flags = 0;
+  bufferlist bl1;
+  bl1.append(std::string(4096, '1'));
+  bufferlist bl2;
+  bl2.append(std::string(4096, '2'));
+  bufferlist bl_copy = bl2;
+
+  std::shared_ptr<GenericWriteLogEntry> overwritten;
+  {
+    /* Keep writeback from starting until both writes are in the log */
+    RWLock::WLocker entry_reader_locker(rwl.entry_reader_lock());
+    MockContextRWL finish_ctx2;
+    expect_context_complete(finish_ctx2, 0);
+    rwl.write({{0, 4096}}, std::move(bl1), fadvise_flags, &finish_ctx2);
+    ASSERT_EQ(0, finish_ctx2.wait());
+    overwritten = rwl.mapped_entry({0, 4096});
+    ASSERT_NE(nullptr, overwritten);
+
+    MockContextRWL finish_ctx3;
+    expect_context_complete(finish_ctx3, 0);
+    rwl.write({{0, 4096}}, std::move(bl2), fadvise_flags, &finish_ctx3);
+    ASSERT_EQ(0, finish_ctx3.wait());
+  }
+
+  MockContextRWL finish_ctx_flush;
+  expect_context_complete(finish_ctx_flush, 0);
+  rwl.flush(&finish_ctx_flush);
+  ASSERT_EQ(0, finish_ctx_flush.wait());
+  ASSERT_EQ(1, rwl.perf_counter(l_librbd_pwl_wb_elided));
+  ASSERT_EQ(4096, rwl.perf_counter(l_librbd_pwl_wb_elided_bytes));
+  ASSERT_TRUE(rwl.can_retire(overwritten));
+
+  MockContextRWL finish_ctx_shutdown;
+  expect_context_complete(finish_ctx_shutdown, 0);
+  rwl.shut_down(&finish_ctx_shutdown);
+  ASSERT_EQ(0, finish_ctx_shutdown.wait());
+
+  bufferlist read_bl;
+  ASSERT_EQ(4096, api::Io<>::read(*ictx, 0, 4096, io::ReadResult{&read_bl}, 0));
+  ASSERT_TRUE(bl_copy.contents_equal(read_bl));
+}
+
+TEST_F(TestMockCacheReplicatedWriteLog, writeback_overwrite_not_completed) {
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  MockImageCtx mock_image_ctx(*ictx);
+  MockImageWriteback mock_image_writeback(mock_image_ctx);
+  MockApi mock_api;
+  TestReplicatedWriteLog rwl(
+      mock_image_ctx, get_cache_state(mock_image_ctx, mock_api),
+      mock_image_writeback, mock_api);
+  expect_op_work_queue(mock_image_ctx);
+  expect_metadata_set(mock_image_ctx);
+
+  MockContextRWL finish_ctx1;
+  expect_context_complete(finish_ctx1, 0);
+  rwl.init(&finish_ctx1);
+  ASSERT_EQ(0, finish_ctx1.wait());
+
+  int fadvise_flags = 0;
+  bufferlist bl1;
+  bl1.append(std::string(4096, '1'));
+  bufferlist bl2;
+  bl2.append(std::string(4096, '2'));
+  bufferlist bl_copy = bl2;
+
+  MockContextRWL finish_ctx3;
+  expect_context_complete(finish_ctx3, 0);
+  std::unique_lock append_locker(rwl.log_append_lock(), std::defer_lock);
+  {
+    RWLock::WLocker entry_reader_locker(rwl.entry_reader_lock());
+    MockContextRWL finish_ctx2;
+    expect_context_complete(finish_ctx2, 0);
+    rwl.write({{0, 4096}}, std::move(bl1), fadvise_flags, &finish_ctx2);
+    ASSERT_EQ(0, finish_ctx2.wait());
+    auto overwritten = rwl.mapped_entry({0, 4096});
+    ASSERT_NE(nullptr, overwritten);
+
+    /* The overwrite takes over the extent, but can't be appended */
+    append_locker.lock();
+    rwl.write({{0, 4096}}, std::move(bl2), fadvise_flags, &finish_ctx3);
+    while (rwl.mapped_entry({0, 4096}) == overwritten) {
+      usleep(1000);
+    }
+  }
+  rwl.writeback_dirty_entries();
+  ASSERT_EQ(0, rwl.perf_counter(l_librbd_pwl_wb_elided));
+  append_locker.unlock();
+  ASSERT_EQ(0, finish_ctx3.wait());
+
+  MockContextRWL finish_ctx_flush;
+  expect_context_complete(finish_ctx_flush, 0);
+  rwl.flush(&finish_ctx_flush);
+  ASSERT_EQ(0, finish_ctx_flush.wait());
+  ASSERT_EQ(0, rwl.perf_counter(l_librbd_pwl_wb_elided));
+
+  MockContextRWL finish_ctx_shutdown;
+  expect_context_complete(finish_ctx_shutdown, 0);
+  rwl.shut_down(&finish_ctx_shutdown);
+  ASSERT_EQ(0, finish_ctx_shutdown.wait());
+
+  bufferlist read_bl;
+  ASSERT_EQ(4096, api::Io<>::read(*ictx, 0, 4096, io::ReadResult{&read_bl}, 0));
+  ASSERT_TRUE(bl_copy.contents_equal(read_bl));
+}
+
+TEST_F(TestMockCacheReplicatedWriteLog, writeback_overwrite_older_sync_gen) {
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  MockImageCtx mock_image_ctx(*ictx);
+  MockImageWriteback mock_image_writeback(mock_image_ctx);
+  MockApi mock_api;
+  TestReplicatedWriteLog rwl(
+      mock_image_ctx, get_cache_state(mock_image_ctx, mock_api),
+      mock_image_writeback, mock_api);
+  expect_op_work_queue(mock_image_ctx);
+  expect_metadata_set(mock_image_ctx);
+
+  MockContextRWL finish_ctx1;
+  expect_context_complete(finish_ctx1, 0);
+  rwl.init(&finish_ctx1);
+  ASSERT_EQ(0, finish_ctx1.wait());
+
+  int fadvise_flags = 0;
+  bufferlist bl1;
+  bl1.append(std::string(4096, '1'));
+  bufferlist bl2;
+  bl2.append(std::string(4096, '2'));
+  bufferlist bl_copy = bl2;
+
+  {
+    RWLock::WLocker entry_reader_locker(rwl.entry_reader_lock());
+    MockContextRWL finish_ctx2;
+    expect_context_complete(finish_ctx2, 0);
+    rwl.write({{0, 4096}}, std::move(bl1), fadvise_flags, &finish_ctx2);
+    ASSERT_EQ(0, finish_ctx2.wait());
+
+    /* A user flush starts a new sync gen for the overwrite */
+    MockContextRWL finish_ctx_user_flush;
+    expect_context_complete(finish_ctx_user_flush, 0);
+    rwl.flush(io::FLUSH_SOURCE_USER, &finish_ctx_user_flush);
+    ASSERT_EQ(0, finish_ctx_user_flush.wait());
+
+    MockContextRWL finish_ctx3;
+    expect_context_complete(finish_ctx3, 0);
+    rwl.write({{0, 4096}}, std::move(bl2), fadvise_flags, &finish_ctx3);
+    ASSERT_EQ(0, finish_ctx3.wait());
+  }
+
+  MockContextRWL finish_ctx_flush;
+  expect_context_complete(finish_ctx_flush, 0);
+  rwl.flush(&finish_ctx_flush);
+  ASSERT_EQ(0, finish_ctx_flush.wait());
+  ASSERT_EQ(0, rwl.perf_counter(l_librbd_pwl_wb_elided));
+
+  MockContextRWL finish_ctx_shutdown;
+  expect_context_complete(finish_ctx_shutdown, 0);
+  rwl.shut_down(&finish_ctx_shutdown);
+  ASSERT_EQ(0, finish_ctx_shutdown.wait());
+
+  bufferlist read_bl;
+  ASSERT_EQ(4096, api::Io<>::read(*ictx, 0, 4096, io::ReadResult{&read_bl}, 0));
+  ASSERT_TRUE(bl_copy.contents_equal(read_bl));
+}
+
 } // namespace pwl
 } // namespace cache
 } // namespace librbd
@@ -125,6 +125,7 @@ TEST_F(TestMockCryptoBlockCrypto, InitContextError) {
   data.append(std::string(4096, '1'));
   expect_get_context(CipherMode::CIPHER_MODE_ENC);
   EXPECT_CALL(cryptor, init_context(_, _, _)).WillOnce(Return(-123));
+  EXPECT_CALL(cryptor, return_context(_, CipherMode::CIPHER_MODE_ENC));
   ASSERT_EQ(-123, bc->encrypt(&data, 0));
 }
 
@@ -134,6 +135,7 @@ TEST_F(TestMockCryptoBlockCrypto, UpdateContextError) {
   expect_get_context(CipherMode::CIPHER_MODE_ENC);
   EXPECT_CALL(cryptor, init_context(_, _, _));
   EXPECT_CALL(cryptor, update_context(_, _, _, _)).WillOnce(Return(-123));
+  EXPECT_CALL(cryptor, return_context(_, CipherMode::CIPHER_MODE_ENC));
   ASSERT_EQ(-123, bc->encrypt(&data, 0));
 }
 
@@ -267,6 +267,31 @@ public:
         }));
   }
 
+  void expect_read(librbd::MockTestImageCtx& mock_image_ctx, uint64_t snap_id,
+                   const interval_set<uint64_t> &extents,
+                   io::ImageDispatchSpec** spec_ref, Context* on_send) {
+    EXPECT_CALL(*mock_image_ctx.io_image_dispatcher,
+                send(IsRead(snap_id, extents)))
+      .WillOnce(Invoke(
+        [spec_ref, on_send](io::ImageDispatchSpec* spec) {
+          *spec_ref = spec;
+          if (on_send != nullptr) {
+            on_send->complete(0);
+          }
+        }));
+  }
+
+  void complete_read(librbd::MockTestImageCtx& mock_image_ctx,
+                     io::ImageDispatchSpec* spec, int r) {
+    if (r < 0) {
+      spec->fail(r);
+      return;
+    }
+
+    spec->image_dispatcher = mock_image_ctx.image_ctx->io_image_dispatcher;
+    mock_image_ctx.image_ctx->io_image_dispatcher->send(spec);
+  }
+
   void expect_write(librados::MockTestMemIoCtxImpl &mock_io_ctx,
                     uint64_t offset, uint64_t length,
                     const SnapContext &snapc, int r) {
@@ -707,6 +732,150 @@ TEST_F(TestMockDeepCopyObjectCopyRequest, WriteSnaps) {
   ASSERT_EQ(0, compare_objects());
 }
 
+TEST_F(TestMockDeepCopyObjectCopyRequest, ReadSnapsInFlight) {
+  // scribble some data
+  interval_set<uint64_t> one;
+  scribble(m_src_image_ctx, 10, 102400, &one);
+  ASSERT_EQ(0, create_snap("one"));
+
+  interval_set<uint64_t> two;
+  scribble(m_src_image_ctx, 10, 102400, &two);
+  ASSERT_EQ(0, create_snap("two"));
+
+  if (one.range_end() < two.range_end()) {
+    interval_set<uint64_t> resize_diff;
+    resize_diff.insert(one.range_end(), two.range_end() - one.range_end());
+    two.union_of(resize_diff);
+  }
+
+  ASSERT_EQ(0, create_snap("copy"));
+  librbd::MockTestImageCtx mock_src_image_ctx(*m_src_image_ctx);
+  librbd::MockTestImageCtx mock_dst_image_ctx(*m_dst_image_ctx);
+
+  librbd::MockExclusiveLock mock_exclusive_lock;
+  prepare_exclusive_lock(mock_dst_image_ctx, mock_exclusive_lock);
+
+  librbd::MockObjectMap mock_object_map;
+  mock_dst_image_ctx.object_map = &mock_object_map;
+
+  expect_op_work_queue(mock_src_image_ctx);
+  expect_test_features(mock_dst_image_ctx);
+  expect_get_object_count(mock_dst_image_ctx);
+
+  C_SaferCond ctx;
+  MockObjectCopyRequest *request = create_request(mock_src_image_ctx,
+                                                  mock_dst_image_ctx, 0,
+                                                  CEPH_NOSNAP, 0, 0, &ctx);
+
+  librados::MockTestMemIoCtxImpl &mock_dst_io_ctx(get_mock_io_ctx(
+    request->get_dst_io_ctx()));
+
+  interval_set<uint64_t> one_extents;
+  one_extents.insert(0, one.range_end());
+
+  io::ImageDispatchSpec* read_one = nullptr;
+  io::ImageDispatchSpec* read_two = nullptr;
+  C_SaferCond reads_sent;
+
+  InSequence seq;
+  expect_list_snaps(mock_src_image_ctx, 0);
+  expect_read(mock_src_image_ctx, m_src_snap_ids[0], one_extents, &read_one,
+              nullptr);
+  expect_read(mock_src_image_ctx, m_src_snap_ids[2], two, &read_two,
+              &reads_sent);
+  expect_start_op(mock_exclusive_lock);
+  expect_update_object_map(mock_dst_image_ctx, mock_object_map,
+                           m_dst_snap_ids[0], OBJECT_EXISTS, 0);
+  expect_start_op(mock_exclusive_lock);
+  expect_update_object_map(mock_dst_image_ctx, mock_object_map,
+                           m_dst_snap_ids[1], OBJECT_EXISTS, 0);
+  expect_start_op(mock_exclusive_lock);
+  expect_update_object_map(mock_dst_image_ctx, mock_object_map,
+                           m_dst_snap_ids[2], is_fast_diff(mock_dst_image_ctx) ?
+                           OBJECT_EXISTS_CLEAN : OBJECT_EXISTS, 0);
+  expect_prepare_copyup(mock_dst_image_ctx);
+  expect_start_op(mock_exclusive_lock);
+  expect_write(mock_dst_io_ctx, 0, one.range_end(), {0, {}}, 0);
+  expect_start_op(mock_exclusive_lock);
+  expect_write(mock_dst_io_ctx, two,
+               {m_dst_snap_ids[0], {m_dst_snap_ids[0]}}, 0);
+
+  request->send();
+
+  // both snapshot reads are issued before either of them completes
+  ASSERT_EQ(0, reads_sent.wait());
+  ASSERT_TRUE(read_one != nullptr);
+  ASSERT_TRUE(read_two != nullptr);
+
+  complete_read(mock_src_image_ctx, read_two, 0);
+  complete_read(mock_src_image_ctx, read_one, 0);
+
+  ASSERT_EQ(0, ctx.wait());
+  ASSERT_EQ(0, compare_objects());
+}
+
+TEST_F(TestMockDeepCopyObjectCopyRequest, ReadSnapsError) {
+  // scribble some data
+  interval_set<uint64_t> one;
+  scribble(m_src_image_ctx, 10, 102400, &one);
+  ASSERT_EQ(0, create_snap("one"));
+
+  interval_set<uint64_t> two;
+  scribble(m_src_image_ctx, 10, 102400, &two);
+  ASSERT_EQ(0, create_snap("two"));
+
+  if (one.range_end() < two.range_end()) {
+    interval_set<uint64_t> resize_diff;
+    resize_diff.insert(one.range_end(), two.range_end() - one.range_end());
+    two.union_of(resize_diff);
+  }
+
+  ASSERT_EQ(0, create_snap("copy"));
+  librbd::MockTestImageCtx mock_src_image_ctx(*m_src_image_ctx);
+  librbd::MockTestImageCtx mock_dst_image_ctx(*m_dst_image_ctx);
+
+  librbd::MockExclusiveLock mock_exclusive_lock;
+  prepare_exclusive_lock(mock_dst_image_ctx, mock_exclusive_lock);
+
+  librbd::MockObjectMap mock_object_map;
+  mock_dst_image_ctx.object_map = &mock_object_map;
+
+  expect_op_work_queue(mock_src_image_ctx);
+  expect_test_features(mock_dst_image_ctx);
+  expect_get_object_count(mock_dst_image_ctx);
+
+  C_SaferCond ctx;
+  MockObjectCopyRequest *request = create_request(mock_src_image_ctx,
+                                                  mock_dst_image_ctx, 0,
+                                                  CEPH_NOSNAP, 0, 0, &ctx);
+
+  interval_set<uint64_t> one_extents;
+  one_extents.insert(0, one.range_end());
+
+  io::ImageDispatchSpec* read_one = nullptr;
+  io::ImageDispatchSpec* read_two = nullptr;
+  C_SaferCond reads_sent;
+
+  InSequence seq;
+  expect_list_snaps(mock_src_image_ctx, 0);
+  expect_read(mock_src_image_ctx, m_src_snap_ids[0], one_extents, &read_one,
+              nullptr);
+  expect_read(mock_src_image_ctx, m_src_snap_ids[2], two, &read_two,
+              &reads_sent);
+
+  request->send();
+
+  ASSERT_EQ(0, reads_sent.wait());
+  ASSERT_TRUE(read_one != nullptr);
+  ASSERT_TRUE(read_two != nullptr);
+
+  // nothing is written once one of the in-flight reads fails
+  complete_read(mock_src_image_ctx, read_two, -EINVAL);
+  complete_read(mock_src_image_ctx, read_one, 0);
+
+  ASSERT_EQ(-EINVAL, ctx.wait());
+}
+
 TEST_F(TestMockDeepCopyObjectCopyRequest, Trim) {
   ASSERT_EQ(0, m_src_image_ctx->operations->metadata_set(
               "conf_rbd_skip_partial_discard", "false"));
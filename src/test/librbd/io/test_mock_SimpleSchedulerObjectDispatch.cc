@@ -464,7 +464,7 @@ TEST_F(TestMockIoSimpleSchedulerObjectDispatch, WriteMerged) {
   ASSERT_EQ(0, cond6.wait());
 }
 
-TEST_F(TestMockIoSimpleSchedulerObjectDispatch, WriteNonSequential) {
+TEST_F(TestMockIoSimpleSchedulerObjectDispatch, WriteOverlapped) {
   librbd::ImageCtx *ictx;
   ASSERT_EQ(0, open_image(m_image_name, &ictx));
 
@@ -504,27 +504,49 @@ TEST_F(TestMockIoSimpleSchedulerObjectDispatch, WriteNonSequential) {
   ASSERT_NE(on_finish2, &cond2);
   ASSERT_NE(timer_task, nullptr);
 
-  expect_dispatch_delayed_requests(mock_image_ctx, 0);
-  expect_schedule_dispatch_delayed_requests(timer_task, nullptr);
-
+  // overwrites the tail of the delayed write and extends it
   object_off = 5;
   data.clear();
   data.append(std::string(10, 'Y'));
   C_SaferCond cond3;
   Context *on_finish3 = &cond3;
-  ASSERT_FALSE(mock_simple_scheduler_object_dispatch.write(
+  C_SaferCond on_dispatched3;
+  ASSERT_TRUE(mock_simple_scheduler_object_dispatch.write(
       0, object_off, std::move(data), mock_image_ctx.get_data_io_context(), 0,
       0, std::nullopt, {}, &object_dispatch_flags, nullptr, &dispatch_result,
-      &on_finish3, nullptr));
+      &on_finish3, &on_dispatched3));
+  ASSERT_EQ(dispatch_result, io::DISPATCH_RESULT_COMPLETE);
   ASSERT_NE(on_finish3, &cond3);
 
+  // expect a single 0~15 request with the newer data on top
+  ceph::bufferlist expected_data;
+  expected_data.append(std::string(5, 'X'));
+  expected_data.append(std::string(10, 'Y'));
+  EXPECT_CALL(*mock_image_ctx.io_object_dispatcher, send(_))
+    .WillOnce(Invoke([&mock_image_ctx, expected_data](ObjectDispatchSpec* spec) {
+                auto req = boost::get<ObjectDispatchSpec::WriteRequest>(
+                  &spec->request);
+                ASSERT_TRUE(req != nullptr);
+                ASSERT_EQ(0U, req->object_off);
+                ASSERT_TRUE(req->data.contents_equal(expected_data));
+                spec->dispatch_result = io::DISPATCH_RESULT_COMPLETE;
+                mock_image_ctx.image_ctx->op_work_queue->queue(
+                    &spec->dispatcher_ctx, 0);
+              }));
+  expect_schedule_dispatch_delayed_requests(timer_task, nullptr);
+
   on_finish1->complete(0);
   ASSERT_EQ(0, cond1.wait());
   ASSERT_EQ(0, on_dispatched2.wait());
+  ASSERT_EQ(0, on_dispatched3.wait());
   on_finish2->complete(0);
-  ASSERT_EQ(0, cond2.wait());
   on_finish3->complete(0);
+  ASSERT_EQ(0, cond2.wait());
   ASSERT_EQ(0, cond3.wait());
+
+  ASSERT_EQ(2U, ictx->perfcounter->get(l_librbd_io_sched_delayed));
+  ASSERT_EQ(1U, ictx->perfcounter->get(l_librbd_io_sched_merged));
+  ASSERT_EQ(1U, ictx->perfcounter->get(l_librbd_io_sched_dispatched));
 }
 
 TEST_F(TestMockIoSimpleSchedulerObjectDispatch, Mixed) {
@@ -819,5 +841,21 @@ TEST_F(TestMockIoSimpleSchedulerObjectDispatch, Timer) {
   ASSERT_EQ(0, cond2.wait());
 }
 
+TEST_F(TestMockIoSimpleSchedulerObjectDispatch, LatencyStatsAvg) {
+  LatencyStats latency_stats;
+  ASSERT_EQ(0U, latency_stats.avg());
+
+  for (int i = 1; i <= LATENCY_STATS_WINDOW_SIZE; i++) {
+    ASSERT_FALSE(latency_stats.is_ready());
+    latency_stats.add(i * 100);
+  }
+  ASSERT_TRUE(latency_stats.is_ready());
+  ASSERT_EQ(550U, latency_stats.avg());
+
+  // the oldest sample (100) leaves the window
+  latency_stats.add(2100);
+  ASSERT_EQ(750U, latency_stats.avg());
+}
+
 } // namespace io
 } // namespace librbd
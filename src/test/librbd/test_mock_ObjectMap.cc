@@ -201,6 +201,49 @@ TEST_F(TestMockObjectMap, NonDetainedUpdate) {
   ASSERT_EQ(0, close_ctx.wait());
 }
 
+TEST_F(TestMockObjectMap, UpdateNotRequired) {
+  REQUIRE_FEATURE(RBD_FEATURE_OBJECT_MAP);
+
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  MockTestImageCtx mock_image_ctx(*ictx);
+
+  InSequence seq;
+  ceph::BitVector<2u> object_map;
+  object_map.resize(4);
+  object_map[0] = OBJECT_EXISTS;
+  MockRefreshRequest mock_refresh_request;
+  expect_refresh(mock_image_ctx, mock_refresh_request, object_map, 0);
+
+  MockUnlockRequest mock_unlock_request;
+  expect_unlock(mock_image_ctx, mock_unlock_request, 0);
+
+  MockObjectMap *mock_object_map = new MockObjectMap(mock_image_ctx, CEPH_NOSNAP);
+  BOOST_SCOPE_EXIT(&mock_object_map) {
+    mock_object_map->put();
+  } BOOST_SCOPE_EXIT_END
+
+  C_SaferCond open_ctx;
+  mock_object_map->open(&open_ctx);
+  ASSERT_EQ(0, open_ctx.wait());
+
+  C_SaferCond update_ctx;
+  {
+    std::shared_lock image_locker{mock_image_ctx.image_lock};
+    ASSERT_FALSE(mock_object_map->aio_update(CEPH_NOSNAP, 0, OBJECT_EXISTS, {},
+                                             {}, false, &update_ctx));
+    ASSERT_FALSE(mock_object_map->aio_update(CEPH_NOSNAP, 1, 4, OBJECT_PENDING,
+                                             {}, {}, false, &update_ctx));
+    ASSERT_FALSE(mock_object_map->aio_update(CEPH_NOSNAP, 4, 8, OBJECT_EXISTS,
+                                             {}, {}, false, &update_ctx));
+  }
+
+  C_SaferCond close_ctx;
+  mock_object_map->close(&close_ctx);
+  ASSERT_EQ(0, close_ctx.wait());
+}
+
 TEST_F(TestMockObjectMap, DetainedUpdate) {
   REQUIRE_FEATURE(RBD_FEATURE_OBJECT_MAP);
 
@@ -1126,6 +1126,123 @@ TEST_F(TestMockImageReplayerJournalReplayer, Replay) {
                                         mock_local_journal_replay));
 }
 
+TEST_F(TestMockImageReplayerJournalReplayer, ReplayMergeWrites) {
+  librbd::MockTestJournal mock_local_journal;
+  librbd::MockTestImageCtx mock_local_image_ctx{*m_local_image_ctx,
+                                                mock_local_journal};
+  ::journal::MockJournaler mock_remote_journaler;
+  MockReplayerListener mock_replayer_listener;
+  MockThreads mock_threads{m_threads};
+  MockStateBuilder mock_state_builder(mock_local_image_ctx,
+                                      mock_remote_journaler,
+                                      {});
+  MockReplayer mock_replayer{
+    &mock_threads, "local mirror uuid", &mock_state_builder,
+    &mock_replayer_listener};
+
+  ::journal::MockReplayEntry mock_replay_entry;
+  expect_work_queue_repeatedly(mock_threads);
+  expect_add_event_after_repeatedly(mock_threads);
+  expect_get_commit_tid_in_debug(mock_replay_entry);
+  expect_get_tag_tid_in_debug(mock_local_journal);
+  EXPECT_CALL(mock_replay_entry, get_data()).Times(4);
+  EXPECT_CALL(mock_remote_journaler, committed(
+                MatcherCast<const ::journal::MockReplayEntryProxy&>(_)))
+    .Times(3);
+
+  InSequence seq;
+
+  MockReplay mock_local_journal_replay;
+  MockEventPreprocessor mock_event_preprocessor;
+  MockReplayStatusFormatter mock_replay_status_formatter;
+  librbd::journal::Listener* local_journal_listener = nullptr;
+  ::journal::ReplayHandler* remote_replay_handler = nullptr;
+  ::journal::JournalMetadataListener* remote_journaler_listener = nullptr;
+  ASSERT_EQ(0, init_entry_replayer(mock_replayer, mock_threads,
+                                   mock_replayer_listener, mock_local_journal,
+                                   mock_remote_journaler,
+                                   mock_local_journal_replay,
+                                   &local_journal_listener,
+                                   &remote_replay_handler,
+                                   &remote_journaler_listener));
+
+  cls::journal::Tag tag =
+    {1, 0, encode_tag_data({librbd::Journal<>::LOCAL_MIRROR_UUID,
+                            librbd::Journal<>::LOCAL_MIRROR_UUID,
+                            true, 0, 0})};
+
+  expect_try_pop_front(mock_remote_journaler, tag.tid, true);
+
+  // replay_flush
+  expect_shut_down(mock_local_journal_replay, false, 0);
+  EXPECT_CALL(mock_local_journal, remove_listener(_));
+  EXPECT_CALL(mock_local_journal, stop_external_replay());
+  expect_start_external_replay(mock_local_journal, &mock_local_journal_replay,
+                               0);
+  expect_local_journal_add_listener(mock_local_journal,
+                                    &local_journal_listener);
+  expect_get_tag(mock_remote_journaler, tag, 0);
+  expect_allocate_tag(mock_local_journal, 0);
+
+  // two adjacent writes are merged, the discard stops the merge
+  bufferlist bl1;
+  bl1.append("ab");
+  bufferlist bl2;
+  bl2.append("cd");
+  librbd::journal::EventEntry write_entry1{
+    librbd::journal::AioWriteEvent(0, 2, bl1)};
+  librbd::journal::EventEntry write_entry2{
+    librbd::journal::AioWriteEvent(2, 2, bl2)};
+  librbd::journal::EventEntry discard_entry{
+    librbd::journal::AioDiscardEvent(4, 2, 0)};
+  EXPECT_CALL(mock_local_journal_replay, decode(_, _))
+    .WillOnce(DoAll(SetArgPointee<1>(write_entry1), Return(0)));
+  expect_try_pop_front(mock_remote_journaler, tag.tid, true);
+  EXPECT_CALL(mock_local_journal_replay, decode(_, _))
+    .WillOnce(DoAll(SetArgPointee<1>(write_entry2), Return(0)));
+  expect_try_pop_front(mock_remote_journaler, tag.tid, true);
+  EXPECT_CALL(mock_local_journal_replay, decode(_, _))
+    .WillOnce(DoAll(SetArgPointee<1>(discard_entry), Return(0)));
+
+  librbd::journal::EventEntry merged_entry;
+  expect_preprocess(mock_event_preprocessor, false, 0);
+  EXPECT_CALL(mock_local_journal_replay, process(_, _, _))
+    .WillOnce(DoAll(SaveArg<0>(&merged_entry),
+                    WithArg<1>(CompleteContext(0)),
+                    WithArg<2>(CompleteContext(0))));
+  EXPECT_CALL(mock_replay_status_formatter, handle_entry_processed(_))
+    .Times(2);
+
+  // the discard is replayed without popping it again
+  EXPECT_CALL(mock_local_journal_replay, decode(_, _))
+    .WillOnce(DoAll(SetArgPointee<1>(discard_entry), Return(0)));
+  expect_preprocess(mock_event_preprocessor, false, 0);
+  expect_process(mock_local_journal_replay, 0, 0);
+  EXPECT_CALL(mock_replay_status_formatter, handle_entry_processed(_));
+
+  // attempt to process the next event
+  C_SaferCond replay_ctx;
+  expect_try_pop_front_return_no_entries(mock_remote_journaler, &replay_ctx);
+
+  // fire
+  remote_replay_handler->handle_entries_available();
+  ASSERT_EQ(0, replay_ctx.wait());
+
+  auto write_event = boost::get<librbd::journal::AioWriteEvent>(
+    &merged_entry.event);
+  ASSERT_TRUE(write_event != nullptr);
+  ASSERT_EQ(0U, write_event->offset);
+  ASSERT_EQ(4U, write_event->length);
+  bufferlist expected_bl;
+  expected_bl.append("abcd");
+  ASSERT_TRUE(expected_bl.contents_equal(write_event->data));
+
+  ASSERT_EQ(0, shut_down_entry_replayer(mock_replayer, mock_threads,
+                                        mock_local_journal,
+                                        mock_remote_journaler,
+                                        mock_local_journal_replay));
+}
+
 TEST_F(TestMockImageReplayerJournalReplayer, DecodeError) {
   librbd::MockTestJournal mock_local_journal;
   librbd::MockTestImageCtx mock_local_image_ctx{*m_local_image_ctx,
@@ -0,0 +1,140 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+/*
+ * Measures data log write throughput and latency through
+ * RGWDataChangesLog::add_entry(): a number of request threads each add
+ * entries for their own bucket shards, either with one write per entry or
+ * through the flusher that writes every entry queued while its previous
+ * write was in flight with a single operation per data log shard
+ * (rgw_data_log_batch_max_entries).
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "common/ceph_argparse.h"
+#include "common/Formatter.h"
+#include "global/global_init.h"
+#include "include/rados/librados.hpp"
+#include "rgw/rgw_datalog.h"
+#include "rgw/rgw_perf_counters.h"
+#include "rgw/rgw_zone.h"
+
+#define dout_subsys ceph_subsys_rgw
+
+using Clock = std::chrono::steady_clock;
+
+static void usage(const char *name)
+{
+  std::cout << name << " <pool> <threads> <entries> <max-batch>\n"
+	    << "\t pool: scratch pool the data log shards are written to.\n"
+	    << "\t threads: number of concurrent writers.\n"
+	    << "\t entries: entries added by each writer.\n"
+	    << "\t max-batch: rgw_data_log_batch_max_entries, 0 writes each "
+	    << "entry from its writer.\n";
+}
+
+int main(int argc, const char **argv)
+{
+  std::vector<const char*> args;
+  argv_to_vec(argc, argv, args);
+  auto cct = global_init(nullptr, args, CEPH_ENTITY_TYPE_CLIENT,
+			 CODE_ENVIRONMENT_UTILITY, 0);
+  common_init_finish(g_ceph_context);
+
+  if (args.size() < 4) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  const std::string pool = args[0];
+  const size_t threads = std::strtoull(args[1], nullptr, 10);
+  const size_t count = std::strtoull(args[2], nullptr, 10);
+  if (threads == 0 || count == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+  g_conf().set_val_or_die("rgw_data_log_batch_max_entries", args[3]);
+  rgw_perf_start(g_ceph_context);
+
+  librados::Rados rados;
+  int r = rados.init_with_context(g_ceph_context);
+  if (r == 0) {
+    r = rados.connect();
+  }
+  if (r < 0) {
+    std::cerr << "failed to connect to the cluster: r=" << r << std::endl;
+    return 1;
+  }
+
+  const DoutPrefix dp(g_ceph_context, dout_subsys, "bench_rgw_datalog: ");
+  RGWZone zone;
+  RGWZoneParams zoneparams;
+  zoneparams.log_pool = rgw_pool(pool);
+  {
+    RGWDataChangesLog datalog(g_ceph_context);
+    r = datalog.start(&dp, &zone, zoneparams, &rados);
+    if (r < 0) {
+      std::cerr << "failed to start the data log in " << pool
+		<< ": r=" << r << std::endl;
+      return 1;
+    }
+
+    std::vector<double> latency(threads);
+    std::vector<int> errors(threads);
+    const auto start = Clock::now();
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < threads; t++) {
+      writers.emplace_back([&, t] {
+	// every entry goes to a bucket shard of its own, so that none of
+	// them is skipped as recently written
+	RGWBucketInfo bucket_info;
+	bucket_info.bucket.name = "bench_rgw_datalog." +
+	  std::to_string(getpid()) + "." + std::to_string(t);
+	std::chrono::duration<double> total{0};
+	for (size_t i = 0; i < count; i++) {
+	  const auto issued = Clock::now();
+	  int ret = datalog.add_entry(&dp, bucket_info, static_cast<int>(i));
+	  total += Clock::now() - issued;
+	  if (ret < 0) {
+	    errors[t]++;
+	  }
+	}
+	latency[t] = total.count() / count;
+      });
+    }
+    for (auto& w : writers) {
+      w.join();
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    double avg_latency = 0;
+    int failed = 0;
+    for (size_t t = 0; t < threads; t++) {
+      avg_latency += latency[t] / threads;
+      failed += errors[t];
+    }
+    std::cout << "threads: " << threads
+	      << " entries: " << threads * count
+	      << " max-batch: " << args[3]
+	      << " elapsed: " << elapsed.count() << "s"
+	      << " rate: " << threads * count / elapsed.count() << " entries/s"
+	      << " avg-latency: " << avg_latency * 1000 << "ms"
+	      << " errors: " << failed << std::endl;
+    r = failed ? -EIO : 0;
+  }
+
+  // avgcount is the number of batched writes, sum the entries they carried
+  JSONFormatter f;
+  perfcounter->dump_formatted(&f, false, "datalog_batch");
+  f.flush(std::cout);
+  std::cout << std::endl;
+  return r < 0 ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+/*
+ * Measures the CSV scan rate of the s3select engine as used by
+ * RGWSelectObj_ObjStore_S3: a generated CSV object is fed to a
+ * csv_object in fixed size segments, the way RADOS reads are handed to
+ * send_response_data().
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <s3select/include/s3select.h>
+
+using namespace s3selectEngine;
+
+static void usage(const char *name)
+{
+  std::cout << name << " <rows> <segment-size> [query]\n"
+	    << "\t rows: number of CSV rows in the generated object.\n"
+	    << "\t segment-size: bytes handed to the engine per call.\n"
+	    << "\t query: SQL statement (default: select count(0) from stdin;)\n";
+}
+
+int main(int argc, const char **argv)
+{
+  if (argc < 3) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  const size_t rows = std::strtoull(argv[1], nullptr, 10);
+  const size_t segment_size = std::strtoull(argv[2], nullptr, 10);
+  const std::string query = argc > 3 ? argv[3] :
+    "select count(0) from stdin;";
+  if (rows == 0 || segment_size == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  std::string object;
+  object.reserve(rows * 48);
+  for (size_t i = 0; i < rows; i++) {
+    object += std::to_string(i) + "," + std::to_string(i % 1000) +
+      ",\"quoted, field\",some-text-column," + std::to_string(i * 7) + "\n";
+  }
+
+  s3select syntax;
+  syntax.parse_query(query.c_str());
+  if (!syntax.get_error_description().empty()) {
+    std::cerr << "failed to parse query: "
+	      << syntax.get_error_description() << std::endl;
+    return 1;
+  }
+
+  csv_object::csv_defintions csv;
+  csv_object csv_obj(&syntax, csv);
+
+  std::string result;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t ofs = 0; ofs < object.size(); ofs += segment_size) {
+    const size_t len = std::min(segment_size, object.size() - ofs);
+    int r = csv_obj.run_s3select_on_stream(result, object.data() + ofs, len,
+					   object.size());
+    if (r < 0) {
+      std::cerr << "s3select failed: " << csv_obj.get_error_description()
+		<< std::endl;
+      return 1;
+    }
+  }
+  const std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::cout << "rows: " << rows
+	    << " bytes: " << object.size()
+	    << " segment: " << segment_size
+	    << " elapsed: " << elapsed.count() << "s"
+	    << " rate: " << (object.size() / elapsed.count()) / (1 << 20)
+	    << " MB/s"
+	    << " result bytes: " << result.size() << std::endl;
+  return 0;
+}
@@ -145,6 +145,51 @@ TEST(TestRGWCrypto, verify_AES_256_CBC_identity)
 }
 
 
+TEST(TestRGWCrypto, verify_AES_256_CBC_fragmented_input)
+{
+  //create some input for encryption
+  const off_t test_range = 256*1024 + 77;
+  buffer::ptr buf(test_range);
+  char* p = buf.c_str();
+  for(size_t i = 0; i < buf.length(); i++)
+    p[i] = i + i*i + (i >> 2);
+
+  bufferlist contiguous;
+  contiguous.append(buf);
+
+  uint8_t key[32];
+  for(size_t i=0;i<sizeof(key);i++)
+    key[i]=i*7;
+  auto aes(AES_256_CBC_create(g_ceph_context, &key[0], 32));
+  ASSERT_NE(aes.get(), nullptr);
+
+  bufferlist expected;
+  ASSERT_TRUE(aes->encrypt(contiguous, 0, test_range, expected, 0));
+
+  for (unsigned int frag : {1, 15, 16, 1000, 4095, 4097})
+  {
+    //same data, split into fragments that straddle encryption chunks
+    bufferlist fragmented;
+    for (off_t ofs = 0; ofs < test_range; ofs += frag) {
+      fragmented.push_back(buffer::copy(buf.c_str() + ofs, std::min<off_t>(frag, test_range - ofs)));
+    }
+
+    bufferlist encrypted;
+    ASSERT_TRUE(aes->encrypt(fragmented, 0, test_range, encrypted, 0));
+    ASSERT_TRUE(encrypted.contents_equal(expected));
+
+    //and decrypt from a fragmented copy of the ciphertext
+    bufferlist encrypted_fragmented;
+    for (off_t ofs = 0; ofs < test_range; ofs += frag) {
+      encrypted_fragmented.push_back(buffer::copy(expected.c_str() + ofs, std::min<off_t>(frag, test_range - ofs)));
+    }
+    bufferlist decrypted;
+    ASSERT_TRUE(aes->decrypt(encrypted_fragmented, 0, test_range, decrypted, 0));
+    ASSERT_TRUE(decrypted.contents_equal(contiguous));
+  }
+}
+
+
 TEST(TestRGWCrypto, verify_AES_256_CBC_identity_2)
 {
   //create some input for encryption
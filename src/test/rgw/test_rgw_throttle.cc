@@ -128,6 +128,27 @@ TEST_F(Aio_Throttle, CostOverWindow)
   EXPECT_EQ(-EDEADLK, c.front().result);
 }
 
+TEST_F(Aio_Throttle, SetWindow)
+{
+  BlockingAioThrottle throttle(1);
+  auto obj = make_obj(__PRETTY_FUNCTION__);
+  {
+    scoped_completion op1;
+    auto c1 = throttle.get(obj, wait_on(op1), 1, 0);
+    EXPECT_TRUE(c1.empty());
+    // would block until op1 completes without the larger window
+    throttle.set_window(2);
+    scoped_completion op2;
+    auto c2 = throttle.get(obj, wait_on(op2), 1, 0);
+    EXPECT_TRUE(c2.empty());
+  }
+  auto completions = throttle.drain();
+  ASSERT_EQ(2u, completions.size());
+  for (auto& c : completions) {
+    EXPECT_EQ(-ECANCELED, c.result);
+  }
+}
+
 TEST_F(Aio_Throttle, ThrottleOverMax)
 {
   constexpr uint64_t window = 4;
@@ -48,11 +48,14 @@ cache_status_t SimplePolicy::alloc_entry(std::string file_name) {
 
   if ((m_cache_size < m_max_cache_size) &&
       (inflight_ops < m_max_inflight_ops)) {
+    // mark it as promoting before dropping the lock so that concurrent
+    // misses on the same object don't start another promotion
     Entry* entry = new Entry();
     ceph_assert(entry != nullptr);
+    entry->status = OBJ_CACHE_SKIP;
+    entry->file_name = file_name;
     m_cache_map[file_name] = entry;
-    wlocker.unlock();
-    update_status(file_name, OBJ_CACHE_SKIP);
+    inflight_ops++;
     return OBJ_CACHE_NONE;  // start promotion request
   }
 
@@ -76,6 +79,7 @@ cache_status_t SimplePolicy::lookup_object(std::string file_name) {
 
   if (entry->status == OBJ_CACHE_PROMOTED || entry->status == OBJ_CACHE_DNE) {
     // bump pos in lru on hit
+    std::lock_guard lru_locker{m_lru_lock};
     m_promoted_lru.lru_touch(entry);
   }
 
@@ -60,6 +60,9 @@ class SimplePolicy : public Policy {
 
   std::atomic<uint64_t> m_cache_size;
 
+  // hits reorder the LRU while only holding m_cache_map_lock for read
+  ceph::mutex m_lru_lock =
+    ceph::make_mutex("rbd::cache::SimplePolicy::m_lru_lock");
   LRU m_promoted_lru;
 };
 
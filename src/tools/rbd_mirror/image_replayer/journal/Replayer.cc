@@ -59,18 +59,18 @@ using librbd::util::create_context_callback;
 template <typename I>
 struct Replayer<I>::C_ReplayCommitted : public Context {
   Replayer* replayer;
-  ReplayEntry replay_entry;
+  std::list<ReplayEntry> replay_entries;
   uint64_t replay_bytes;
   utime_t replay_start_time;
 
-  C_ReplayCommitted(Replayer* replayer, ReplayEntry &&replay_entry,
+  C_ReplayCommitted(Replayer* replayer, std::list<ReplayEntry> &&replay_entries,
                     uint64_t replay_bytes, const utime_t &replay_start_time)
-    : replayer(replayer), replay_entry(std::move(replay_entry)),
+    : replayer(replayer), replay_entries(std::move(replay_entries)),
       replay_bytes(replay_bytes), replay_start_time(replay_start_time) {
   }
 
   void finish(int r) override {
-    replayer->handle_process_entry_safe(replay_entry, replay_bytes,
+    replayer->handle_process_entry_safe(replay_entries, replay_bytes,
                                         replay_start_time, r);
   }
 };
@@ -815,8 +815,12 @@ void Replayer<I>::handle_replay_ready(
     return;
   }
 
-  if (!m_state_builder->remote_journaler->try_pop_front(&m_replay_entry,
-                                                        &m_replay_tag_tid)) {
+  if (m_next_replay_entry_valid) {
+    m_replay_entry = std::move(m_next_replay_entry);
+    m_replay_tag_tid = m_next_replay_tag_tid;
+    m_next_replay_entry_valid = false;
+  } else if (!m_state_builder->remote_journaler->try_pop_front(
+               &m_replay_entry, &m_replay_tag_tid)) {
     dout(20) << "no entries ready for replay" << dendl;
     return;
   }
@@ -973,7 +977,7 @@ void Replayer<I>::allocate_local_tag() {
          local_tag_data.predecessor.mirror_uuid ==
            librbd::Journal<>::LOCAL_MIRROR_UUID)) {
       dout(15) << "skipping stale demotion event" << dendl;
-      handle_process_entry_safe(m_replay_entry, m_replay_bytes,
+      handle_process_entry_safe({m_replay_entry}, m_replay_bytes,
                                 m_replay_start_time, 0);
       handle_replay_ready();
       return;
@@ -1032,6 +1036,7 @@ void Replayer<I>::preprocess_entry() {
     m_event_entry.timestamp,
     m_state_builder->local_image_ctx->mirroring_replay_delay);
   if (delay == 0) {
+    merge_write_entries();
     handle_preprocess_entry_ready(0);
     return;
   }
@@ -1051,6 +1056,58 @@ void Replayer<I>::preprocess_entry() {
   m_threads->timer->add_event_after(delay, m_delayed_preprocess_task);
 }
 
+template <typename I>
+void Replayer<I>::merge_write_entries() {
+  // large writes are split across several journal entries: fold the
+  // consecutive entries of adjacent writes that are already available
+  // into a single write so that they are replayed (and committed) as one
+  auto write_event = boost::get<librbd::journal::AioWriteEvent>(
+    &m_event_entry.event);
+  auto local_image_ctx = m_state_builder->local_image_ctx;
+  if (write_event == nullptr || local_image_ctx->mirroring_replay_delay > 0) {
+    return;
+  }
+
+  auto cct = static_cast<CephContext *>(local_image_ctx->cct);
+  uint64_t max_merge_bytes = cct->_conf.get_val<Option::size_t>(
+    "rbd_mirror_journal_max_merge_bytes");
+
+  std::unique_lock locker{m_lock};
+  ceph_assert(m_merged_replay_entries.empty());
+  ceph_assert(!m_next_replay_entry_valid);
+  while (write_event->length < max_merge_bytes &&
+         !is_replay_complete(locker)) {
+    ReplayEntry replay_entry;
+    uint64_t replay_tag_tid;
+    if (!m_state_builder->remote_journaler->try_pop_front(&replay_entry,
+                                                          &replay_tag_tid)) {
+      break;
+    }
+
+    bufferlist data = replay_entry.get_data();
+    auto it = data.cbegin();
+    librbd::journal::EventEntry event_entry;
+    int r = m_local_journal_replay->decode(&it, &event_entry);
+    auto next_write_event = boost::get<librbd::journal::AioWriteEvent>(
+      &event_entry.event);
+    if (r < 0 || replay_tag_tid != m_replay_tag_tid ||
+        next_write_event == nullptr ||
+        next_write_event->offset != write_event->offset + write_event->length ||
+        write_event->length + next_write_event->length > max_merge_bytes) {
+      m_next_replay_entry = std::move(replay_entry);
+      m_next_replay_tag_tid = replay_tag_tid;
+      m_next_replay_entry_valid = true;
+      break;
+    }
+
+    dout(20) << "merging entry tid=" << replay_entry.get_commit_tid() << dendl;
+    write_event->data.claim_append(next_write_event->data);
+    write_event->length += next_write_event->length;
+    m_merged_replay_entries.push_back(std::move(replay_entry));
+    m_merged_replay_bytes.push_back(data.length());
+  }
+}
+
 template <typename I>
 void Replayer<I>::handle_delayed_preprocess_task(int r) {
   dout(20) << "r=" << r << dendl;
@@ -1104,8 +1161,17 @@ void Replayer<I>::process_entry() {
 
   Context *on_ready = create_context_callback<
     Replayer, &Replayer<I>::handle_process_entry_ready>(this);
-  Context *on_commit = new C_ReplayCommitted(this, std::move(m_replay_entry),
-                                             m_replay_bytes,
+  std::list<ReplayEntry> replay_entries;
+  replay_entries.push_back(std::move(m_replay_entry));
+  replay_entries.splice(replay_entries.end(), m_merged_replay_entries);
+
+  uint64_t replay_bytes = m_replay_bytes;
+  for (auto bytes : m_merged_replay_bytes) {
+    replay_bytes += bytes;
+  }
+
+  Context *on_commit = new C_ReplayCommitted(this, std::move(replay_entries),
+                                             replay_bytes,
                                              m_replay_start_time);
 
   m_local_journal_replay->process(m_event_entry, on_ready, on_commit);
@@ -1131,6 +1197,10 @@ void Replayer<I>::handle_process_entry_ready(int r) {
   }
 
   m_replay_status_formatter->handle_entry_processed(m_replay_bytes);
+  for (auto bytes : m_merged_replay_bytes) {
+    m_replay_status_formatter->handle_entry_processed(bytes);
+  }
+  m_merged_replay_bytes.clear();
 
   if (update_status) {
     unregister_perf_counters();
@@ -1144,33 +1214,36 @@ void Replayer<I>::handle_process_entry_ready(int r) {
 
 template <typename I>
 void Replayer<I>::handle_process_entry_safe(
-    const ReplayEntry &replay_entry, uint64_t replay_bytes,
+    const std::list<ReplayEntry> &replay_entries, uint64_t replay_bytes,
     const utime_t &replay_start_time, int r) {
-  dout(20) << "commit_tid=" << replay_entry.get_commit_tid() << ", r=" << r
-           << dendl;
+  dout(20) << "commit_tid=" << replay_entries.front().get_commit_tid() << ", "
+           << "entries=" << replay_entries.size() << ", r=" << r << dendl;
 
   if (r < 0) {
     derr << "failed to commit journal event: " << cpp_strerror(r) << dendl;
     handle_replay_complete(r, "failed to commit journal event");
   } else {
     ceph_assert(m_state_builder->remote_journaler != nullptr);
-    m_state_builder->remote_journaler->committed(replay_entry);
+    for (auto& replay_entry : replay_entries) {
+      m_state_builder->remote_journaler->committed(replay_entry);
+    }
   }
 
+  uint64_t replay_count = replay_entries.size();
   auto latency = ceph_clock_now() - replay_start_time;
   if (g_perf_counters) {
-    g_perf_counters->inc(l_rbd_mirror_replay);
+    g_perf_counters->inc(l_rbd_mirror_replay, replay_count);
     g_perf_counters->inc(l_rbd_mirror_replay_bytes, replay_bytes);
     g_perf_counters->tinc(l_rbd_mirror_replay_latency, latency);
   }
 
   auto ctx = new LambdaContext(
-    [this, replay_bytes, latency](int r) {
+    [this, replay_count, replay_bytes, latency](int r) {
       std::unique_lock locker{m_lock};
       schedule_flush_local_replay_task();
 
       if (m_perf_counters) {
-        m_perf_counters->inc(l_rbd_mirror_replay);
+        m_perf_counters->inc(l_rbd_mirror_replay, replay_count);
         m_perf_counters->inc(l_rbd_mirror_replay_bytes, replay_bytes);
         m_perf_counters->tinc(l_rbd_mirror_replay_latency, latency);
       }
@@ -14,8 +14,10 @@
 #include "librbd/ImageCtx.h"
 #include "librbd/journal/Types.h"
 #include "librbd/journal/TypeTraits.h"
+#include <list>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace journal { class Journaler; }
 namespace librbd {
@@ -217,6 +219,15 @@ private:
   librbd::journal::TagData m_replay_tag_data;
   librbd::journal::EventEntry m_event_entry;
 
+  // consecutive write entries merged into m_event_entry
+  std::list<ReplayEntry> m_merged_replay_entries;
+  std::vector<uint64_t> m_merged_replay_bytes;
+
+  // entry popped while merging that must be replayed next
+  bool m_next_replay_entry_valid = false;
+  ReplayEntry m_next_replay_entry;
+  uint64_t m_next_replay_tag_tid = 0;
+
   AsyncOpTracker m_flush_tracker;
 
   AsyncOpTracker m_event_replay_tracker;
@@ -287,13 +298,14 @@ private:
   void handle_replay_ready(std::unique_lock<ceph::mutex>& locker);
 
   void preprocess_entry();
+  void merge_write_entries();
   void handle_delayed_preprocess_task(int r);
   void handle_preprocess_entry_ready(int r);
   void handle_preprocess_entry_safe(int r);
 
   void process_entry();
   void handle_process_entry_ready(int r);
-  void handle_process_entry_safe(const ReplayEntry& replay_entry,
+  void handle_process_entry_safe(const std::list<ReplayEntry>& replay_entries,
                                  uint64_t relay_bytes,
                                  const utime_t &replay_start_time, int r);
 
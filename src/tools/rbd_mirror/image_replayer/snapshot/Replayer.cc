@@ -251,6 +251,12 @@ bool Replayer<I>::get_replay_status(std::string* description,
     // synced and not the consistency point in time.
     root_obj["local_snapshot_timestamp"] =
       matching_remote_snap_it->second.timestamp.sec();
+
+    // how far the local image trails the newest remote consistency point
+    auto lag = remote_snap_info->timestamp.sec() -
+               matching_remote_snap_it->second.timestamp.sec();
+    root_obj["replay_lag_seconds"] = static_cast<uint64_t>(
+      std::max<int64_t>(0, lag));
   }
 
   matching_remote_snap_it = m_state_builder->remote_image_ctx->snap_info.find(
@@ -272,6 +278,11 @@ bool Replayer<I>::get_replay_status(std::string* description,
     m_bytes_per_snapshot);
   root_obj["bytes_per_snapshot"] = round_to_two_places(bytes_per_snapshot);
 
+  auto seconds_per_snapshot = boost::accumulators::rolling_mean(
+    m_seconds_per_snapshot);
+  root_obj["seconds_per_snapshot"] = round_to_two_places(
+    seconds_per_snapshot);
+
   auto pending_bytes = bytes_per_snapshot * m_pending_snapshots;
   if (bytes_per_second > 0 && m_pending_snapshots > 0) {
     std::uint64_t seconds_until_synced = round_to_two_places(
@@ -1045,7 +1056,12 @@ void Replayer<I>::copy_image() {
            << m_local_mirror_snap_ns.last_copied_object_number << ", "
            << "snap_seqs=" << m_local_mirror_snap_ns.snap_seqs << dendl;
 
-  m_snapshot_bytes = 0;
+  {
+    std::unique_lock locker{m_lock};
+    m_snapshot_bytes = 0;
+    m_snapshot_sync_start = ceph::mono_clock::now();
+  }
+
   m_deep_copy_handler = new DeepCopyHandler(this);
   auto ctx = create_context_callback<
     Replayer<I>, &Replayer<I>::handle_copy_image>(this);
@@ -1078,6 +1094,10 @@ void Replayer<I>::handle_copy_image(int r) {
     std::unique_lock locker{m_lock};
     m_bytes_per_snapshot(m_snapshot_bytes);
     m_snapshot_bytes = 0;
+
+    std::chrono::duration<double> sync_duration =
+      ceph::mono_clock::now() - m_snapshot_sync_start;
+    m_seconds_per_snapshot(sync_duration.count());
   }
 
   apply_image_state();
@@ -6,6 +6,7 @@
 
 #include "tools/rbd_mirror/image_replayer/Replayer.h"
 #include "common/ceph_mutex.h"
+#include "common/ceph_time.h"
 #include "common/AsyncOpTracker.h"
 #include "cls/rbd/cls_rbd_types.h"
 #include "librbd/mirror/snapshot/Types.h"
@@ -239,6 +240,12 @@ private:
       boost::accumulators::tag::rolling_mean>> m_bytes_per_snapshot{
     boost::accumulators::tag::rolling_window::window_size = 2};
 
+  ceph::mono_time m_snapshot_sync_start;
+  boost::accumulators::accumulator_set<
+    double, boost::accumulators::stats<
+      boost::accumulators::tag::rolling_mean>> m_seconds_per_snapshot{
+    boost::accumulators::tag::rolling_window::window_size = 2};
+
   uint32_t m_pending_snapshots = 0;
 
   bool m_remote_image_updated = false;